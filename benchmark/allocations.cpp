@@ -0,0 +1,76 @@
+#include "allocations.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+  /**
+   * The counters are thread-local, as atomic counters would noticeably slow down every allocation.
+   */
+  struct Counters {
+    size_t allocations;
+    size_t bytes;
+  };
+
+  thread_local Counters counters = {0, 0};
+
+#ifdef BENCHMARK_ALLOCATIONS_TRACK_LIVE
+  /**
+   * Live values are counted globally, as they may be freed by another thread than the one that
+   * allocated them.
+   */
+  std::atomic<size_t> liveAllocations{0};
+  std::atomic<size_t> liveBytesCounter{0};
+
+  /**
+   * Every allocation is preceded by a header storing its size, so that the live bytes can be
+   * updated when it is freed. The header preserves the alignment guaranteed by `malloc`.
+   */
+  constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+#else
+  constexpr size_t HEADER_SIZE = 0;
+#endif
+}  // namespace
+
+size_t benchmark_allocations::count() { return counters.allocations; }
+
+size_t benchmark_allocations::bytes() { return counters.bytes; }
+
+#ifdef BENCHMARK_ALLOCATIONS_TRACK_LIVE
+size_t benchmark_allocations::liveCount() { return liveAllocations.load(); }
+
+size_t benchmark_allocations::liveBytes() { return liveBytesCounter.load(); }
+#endif
+
+// The array and nothrow forms of the global `operator new` and `operator delete` forward to these.
+// Allocations of over-aligned types are not counted.
+
+void *operator new(size_t size) {
+  if (auto block = static_cast<char *>(std::malloc(HEADER_SIZE + size))) {
+    counters.allocations++;
+    counters.bytes += size;
+#ifdef BENCHMARK_ALLOCATIONS_TRACK_LIVE
+    *reinterpret_cast<size_t *>(block) = size;
+    liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    liveBytesCounter.fetch_add(size, std::memory_order_relaxed);
+#endif
+    return block + HEADER_SIZE;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+  if (!ptr) {
+    return;
+  }
+  auto block = static_cast<char *>(ptr) - HEADER_SIZE;
+#ifdef BENCHMARK_ALLOCATIONS_TRACK_LIVE
+  liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+  liveBytesCounter.fetch_sub(*reinterpret_cast<size_t *>(block), std::memory_order_relaxed);
+#endif
+  std::free(block);
+}
+
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+namespace benchmark_allocations {
+
+  /**
+   * The number of calls to the global `operator new` by the current thread.
+   */
+  size_t count();
+
+  /**
+   * The number of bytes requested from the global `operator new` by the current thread.
+   */
+  size_t bytes();
+
+#ifdef BENCHMARK_ALLOCATIONS_TRACK_LIVE
+  /**
+   * The number of allocations that have not been freed yet, by any thread. Only available when
+   * compiled with `BENCHMARK_ALLOCATIONS_TRACK_LIVE`, which is set for the footprint report only,
+   * as it stores a size header in front of every allocation and shifts malloc's size classes.
+   */
+  size_t liveCount();
+
+  /**
+   * Same as `liveCount`, but in bytes, excluding allocator overhead.
+   */
+  size_t liveBytes();
+#endif
+
+  /**
+   * Reports the average number of heap allocations per iteration of the benchmark as the
+   * `allocs/op` counter. Construct it before the benchmark loop, in the benchmarking thread.
+   */
+  class Counter {
+  private:
+    benchmark::State &state;
+    size_t start;
+
+  public:
+    explicit Counter(benchmark::State &_state) : state(_state), start(count()) {}
+
+    Counter(const Counter &) = delete;
+    Counter &operator=(const Counter &) = delete;
+
+    ~Counter() {
+      state.counters["allocs/op"]
+          = benchmark::Counter(double(count() - start), benchmark::Counter::kAvgIterations);
+    }
+  };
+
+}  // namespace benchmark_allocations
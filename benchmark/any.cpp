@@ -0,0 +1,327 @@
+#include <benchmark/benchmark.h>
+#include <revisited/any.h>
+
+#include <any>
+#include <array>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <variant>
+#include <vector>
+
+#include "allocations.h"
+#include "perf_counters.h"
+
+/**
+ * `revisited::Any` compared to `std::any` with `std::any_cast` and `std::variant` with
+ * `std::visit`. Every benchmark reports the number of heap allocations per iteration.
+ */
+
+namespace any_benchmark {
+
+  using revisited::Any;
+
+  template <size_t N> struct Payload {
+    std::array<char, N> bytes{};
+  };
+
+  using Small = Payload<8>;
+  using Medium = Payload<64>;
+  using Large = Payload<512>;
+
+  using PayloadVariant = std::variant<Small, Medium, Large>;
+
+  struct Base {
+    int value = 1;
+  };
+
+  struct Derived : public Base {
+    int extra = 2;
+  };
+
+  struct Other : public Base {
+    double extra = 3;
+  };
+
+  using BaseVariant = std::variant<Derived, Other>;
+
+  template <class... F> struct Overloaded : F... { using F::operator()...; };
+  template <class... F> Overloaded(F...) -> Overloaded<F...>;
+
+  // ---- construction and destruction ----
+
+  template <class T> void ConstructAny(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    T value;
+    for (auto _ : state) {
+      Any any(value);
+      benchmark::DoNotOptimize(any);
+    }
+  }
+
+  template <class T> void ConstructStdAny(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    T value;
+    for (auto _ : state) {
+      std::any any(value);
+      benchmark::DoNotOptimize(any);
+    }
+  }
+
+  template <class T> void ConstructVariant(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    T value;
+    for (auto _ : state) {
+      PayloadVariant variant(value);
+      benchmark::DoNotOptimize(variant);
+    }
+  }
+
+  // ---- copy and move ----
+
+  /**
+   * Copies of an `Any` share the stored value, while `std::any` and `std::variant` copy it.
+   */
+  template <class Value, class T> void Copy(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    Value value{T()};
+    for (auto _ : state) {
+      Value copy(value);
+      benchmark::DoNotOptimize(copy);
+    }
+  }
+
+  template <class Value, class T> void Move(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    Value a{T()}, b{T()};
+    for (auto _ : state) {
+      a = std::move(b);
+      b = std::move(a);
+      benchmark::DoNotOptimize(b);
+    }
+  }
+
+  // ---- exact get ----
+
+  void GetExactAny(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    Any any = 42;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(any);
+      benchmark::DoNotOptimize(any.get<int>());
+    }
+  }
+
+  void GetExactStdAny(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    std::any any = 42;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(any);
+      benchmark::DoNotOptimize(std::any_cast<int>(any));
+    }
+  }
+
+  void GetExactVariant(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    std::variant<int, double, std::string> variant = 42;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(variant);
+      benchmark::DoNotOptimize(std::visit(
+          Overloaded{[](int v) { return v; }, [](auto &&) -> int { throw std::bad_cast(); }},
+          variant));
+    }
+  }
+
+  // ---- numeric conversion ----
+
+  void GetConvertedAny(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    Any any = 42;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(any);
+      benchmark::DoNotOptimize(any.get<double>());
+    }
+  }
+
+  /**
+   * `std::any` cannot convert values, so all numeric types are tried in the order used by
+   * `REVISITED_NUMERIC_TYPES`.
+   */
+  template <class... T> double anyToDouble(const std::any &any) {
+    double result;
+    bool found = ((std::any_cast<T>(&any) && (result = double(*std::any_cast<T>(&any)), true))
+                  || ...);
+    if (!found) {
+      throw std::bad_any_cast();
+    }
+    return result;
+  }
+
+  void GetConvertedStdAny(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    std::any any = 42;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(any);
+      benchmark::DoNotOptimize(
+          anyToDouble<char, unsigned char, short int, unsigned short int, int, unsigned int,
+                      long int, unsigned long int, long long int, unsigned long long int, float,
+                      double, long double>(any));
+    }
+  }
+
+  void GetConvertedVariant(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    std::variant<int, float, double> variant = 42;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(variant);
+      benchmark::DoNotOptimize(std::visit([](auto v) { return double(v); }, variant));
+    }
+  }
+
+  // ---- inheritance-aware get ----
+
+  void GetBaseAny(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    Any any;
+    any.setWithBases<Derived, Base>();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(any);
+      benchmark::DoNotOptimize(any.get<const Base &>().value);
+    }
+  }
+
+  /**
+   * `std::any` has no notion of base classes, so the stored type has to be known exactly.
+   */
+  void GetBaseStdAny(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    std::any any = Derived();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(any);
+      const Base &base = std::any_cast<const Derived &>(any);
+      benchmark::DoNotOptimize(base.value);
+    }
+  }
+
+  void GetBaseVariant(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    BaseVariant variant = Derived();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(variant);
+      benchmark::DoNotOptimize(
+          std::visit([](const Base &base) -> const Base & { return base; }, variant).value);
+    }
+  }
+
+  // ---- failed tryGet ----
+
+  void TryGetMissAny(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    Any any = 42;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(any);
+      benchmark::DoNotOptimize(any.tryGet<std::string>());
+    }
+  }
+
+  void TryGetMissStdAny(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    std::any any = 42;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(any);
+      benchmark::DoNotOptimize(std::any_cast<std::string>(&any));
+    }
+  }
+
+  void TryGetMissVariant(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    std::variant<int, double, std::string> variant = 42;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(variant);
+      benchmark::DoNotOptimize(std::get_if<std::string>(&variant));
+    }
+  }
+
+  // ---- getShared ----
+
+  void GetSharedAny(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    Any any = Medium();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(any);
+      benchmark::DoNotOptimize(any.getShared<Medium>());
+    }
+  }
+
+  /**
+   * `std::any` and `std::variant` can only share values that are stored as `std::shared_ptr`.
+   */
+  void GetSharedStdAny(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    std::any any = std::make_shared<Medium>();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(any);
+      benchmark::DoNotOptimize(std::any_cast<const std::shared_ptr<Medium> &>(any));
+    }
+  }
+
+  void GetSharedVariant(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    std::variant<std::shared_ptr<Medium>, int> variant = std::make_shared<Medium>();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(variant);
+      benchmark::DoNotOptimize(std::get<std::shared_ptr<Medium>>(variant));
+    }
+  }
+
+  // ---- registration ----
+
+  using Benchmark = void (*)(benchmark::State &);
+
+  bool registerBenchmarks(const std::vector<std::pair<std::string, Benchmark>> &benchmarks) {
+    for (auto &[name, function] : benchmarks) {
+      benchmark_perf_counters::registerBenchmark("Any/" + name, function);
+    }
+    return true;
+  }
+
+  const bool registered = registerBenchmarks({
+      {"Construct/Any/8", ConstructAny<Small>},
+      {"Construct/Any/64", ConstructAny<Medium>},
+      {"Construct/Any/512", ConstructAny<Large>},
+      {"Construct/StdAny/8", ConstructStdAny<Small>},
+      {"Construct/StdAny/64", ConstructStdAny<Medium>},
+      {"Construct/StdAny/512", ConstructStdAny<Large>},
+      {"Construct/Variant/8", ConstructVariant<Small>},
+      {"Construct/Variant/64", ConstructVariant<Medium>},
+      {"Construct/Variant/512", ConstructVariant<Large>},
+      {"Copy/Any/8", Copy<Any, Small>},
+      {"Copy/Any/512", Copy<Any, Large>},
+      {"Copy/StdAny/8", Copy<std::any, Small>},
+      {"Copy/StdAny/512", Copy<std::any, Large>},
+      {"Copy/Variant/8", Copy<PayloadVariant, Small>},
+      {"Copy/Variant/512", Copy<PayloadVariant, Large>},
+      {"Move/Any/8", Move<Any, Small>},
+      {"Move/Any/512", Move<Any, Large>},
+      {"Move/StdAny/8", Move<std::any, Small>},
+      {"Move/StdAny/512", Move<std::any, Large>},
+      {"Move/Variant/8", Move<PayloadVariant, Small>},
+      {"Move/Variant/512", Move<PayloadVariant, Large>},
+      {"GetExact/Any", GetExactAny},
+      {"GetExact/StdAny", GetExactStdAny},
+      {"GetExact/Variant", GetExactVariant},
+      {"GetConverted/Any", GetConvertedAny},
+      {"GetConverted/StdAny", GetConvertedStdAny},
+      {"GetConverted/Variant", GetConvertedVariant},
+      {"GetBase/Any", GetBaseAny},
+      {"GetBase/StdAny", GetBaseStdAny},
+      {"GetBase/Variant", GetBaseVariant},
+      {"TryGetMiss/Any", TryGetMissAny},
+      {"TryGetMiss/StdAny", TryGetMissStdAny},
+      {"TryGetMiss/Variant", TryGetMissVariant},
+      {"GetShared/Any", GetSharedAny},
+      {"GetShared/StdAny", GetSharedStdAny},
+      {"GetShared/Variant", GetSharedVariant},
+  });
+
+}  // namespace any_benchmark
@@ -0,0 +1,394 @@
+#include <benchmark/benchmark.h>
+#include <revisited/any_function.h>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "allocations.h"
+#include "perf_counters.h"
+
+/**
+ * `revisited::AnyFunction` compared to direct calls, `std::function` and virtual calls for
+ * functions with 0 to 8 parameters of different kinds. Every benchmark reports the number of heap
+ * allocations per iteration.
+ */
+
+namespace any_function_benchmark {
+
+  using revisited::Any;
+  using revisited::AnyArguments;
+  using revisited::AnyFunction;
+
+  constexpr size_t MAX_ARGUMENTS = 8;
+
+  int sink = 0;
+
+  // ---- parameter kinds ----
+
+  struct Scalar {
+    using Parameter = int;
+    using Value = int;
+    static Value make(size_t i) { return int(i); }
+  };
+
+  /**
+   * Strings longer than the small string optimization, passed by const reference.
+   */
+  struct String {
+    using Parameter = const std::string &;
+    using Value = std::string;
+    static Value make(size_t i) { return std::string(32, char('a' + i)); }
+  };
+
+  struct Reference {
+    using Parameter = int &;
+    using Value = int;
+    static Value make(size_t i) { return int(i); }
+  };
+
+  struct AnyValue {
+    using Parameter = const Any &;
+    using Value = Any;
+    static Value make(size_t i) { return Any(int(i)); }
+  };
+
+  inline int weight(int v) { return v; }
+  inline int weight(const std::string &v) { return int(v.size()); }
+  inline int weight(const Any &v) { return int(bool(v)); }
+
+  template <class Kind, size_t> using Parameter = typename Kind::Parameter;
+
+  // ---- implementations ----
+
+  template <class Kind, class R, class Indices> struct Function;
+  template <class Kind, class R, size_t... I> struct Function<Kind, R, std::index_sequence<I...>> {
+    R operator()(Parameter<Kind, I>... args) const {
+      int result = (0 + ... + weight(args));
+      if constexpr (std::is_void<R>::value) {
+        sink += result;
+      } else {
+        return result;
+      }
+    }
+
+    struct Interface {
+      virtual R operator()(Parameter<Kind, I>... args) const = 0;
+      virtual ~Interface() {}
+    };
+
+    struct Implementation : public Interface {
+      R operator()(Parameter<Kind, I>... args) const override { return Function()(args...); }
+    };
+
+    using StdFunction = std::function<R(Parameter<Kind, I>...)>;
+  };
+
+  template <class F> void consume(const F &f) {
+    if constexpr (std::is_void<decltype(f())>::value) {
+      f();
+    } else {
+      benchmark::DoNotOptimize(f());
+    }
+  }
+
+  template <class Kind, size_t N> std::array<typename Kind::Value, N> makeValues() {
+    std::array<typename Kind::Value, N> values;
+    for (size_t i = 0; i < N; ++i) {
+      values[i] = Kind::make(i);
+    }
+    return values;
+  }
+
+  // ---- calls ----
+
+  template <class Kind, class R, size_t N> struct Calls {
+    using F = Function<Kind, R, std::make_index_sequence<N>>;
+
+    static void Direct(benchmark::State &state) {
+      benchmark_allocations::Counter allocations(state);
+      auto values = makeValues<Kind, N>();
+      F f;
+      for (auto _ : state) {
+        benchmark::DoNotOptimize(values);
+        consume([&]() { return std::apply(f, values); });
+      }
+    }
+
+    static void Virtual(benchmark::State &state) {
+      benchmark_allocations::Counter allocations(state);
+      auto values = makeValues<Kind, N>();
+      std::unique_ptr<typename F::Interface> f = std::make_unique<typename F::Implementation>();
+      for (auto _ : state) {
+        benchmark::DoNotOptimize(values);
+        consume([&]() { return std::apply(*f, values); });
+      }
+    }
+
+    static void StdFunction(benchmark::State &state) {
+      benchmark_allocations::Counter allocations(state);
+      auto values = makeValues<Kind, N>();
+      typename F::StdFunction f = F();
+      for (auto _ : state) {
+        benchmark::DoNotOptimize(values);
+        consume([&]() { return std::apply(f, values); });
+      }
+    }
+
+    /**
+     * Captures the arguments on every call, as done by `AnyFunction::operator()`.
+     */
+    static void AnyFunctionCall(benchmark::State &state) {
+      benchmark_allocations::Counter allocations(state);
+      auto values = makeValues<Kind, N>();
+      AnyFunction f = F();
+      for (auto _ : state) {
+        benchmark::DoNotOptimize(values);
+        benchmark::DoNotOptimize(std::apply(f, values));
+      }
+    }
+
+    /**
+     * Calls with previously captured arguments.
+     */
+    static void AnyFunctionArguments(benchmark::State &state) {
+      benchmark_allocations::Counter allocations(state);
+      auto values = makeValues<Kind, N>();
+      AnyFunction f = F();
+      auto arguments = std::apply(
+          [](auto &... v) { return revisited::makeAnyArguments(v...); }, values);
+      for (auto _ : state) {
+        benchmark::DoNotOptimize(arguments);
+        benchmark::DoNotOptimize(f.call(arguments));
+      }
+    }
+  };
+
+  // ---- variadic AnyFunctions ----
+
+  int countArguments(const AnyArguments &args) {
+    int result = 0;
+    for (auto &arg : args) {
+      result += arg.get<int>();
+    }
+    return result;
+  }
+
+  /**
+   * All implementations receive the same `AnyArguments`, so only the overhead of the call itself
+   * differs.
+   */
+  template <size_t N> struct VariadicCalls {
+    struct Interface {
+      virtual int operator()(const AnyArguments &) const = 0;
+      virtual ~Interface() {}
+    };
+
+    struct Implementation : public Interface {
+      int operator()(const AnyArguments &args) const override { return countArguments(args); }
+    };
+
+    static AnyArguments makeArguments() {
+      auto values = makeValues<Scalar, N>();
+      return std::apply([](auto &... v) { return revisited::makeAnyArguments(v...); }, values);
+    }
+
+    static void Direct(benchmark::State &state) {
+      benchmark_allocations::Counter allocations(state);
+      auto arguments = makeArguments();
+      for (auto _ : state) {
+        benchmark::DoNotOptimize(arguments);
+        benchmark::DoNotOptimize(countArguments(arguments));
+      }
+    }
+
+    static void Virtual(benchmark::State &state) {
+      benchmark_allocations::Counter allocations(state);
+      auto arguments = makeArguments();
+      std::unique_ptr<Interface> f = std::make_unique<Implementation>();
+      for (auto _ : state) {
+        benchmark::DoNotOptimize(arguments);
+        benchmark::DoNotOptimize((*f)(arguments));
+      }
+    }
+
+    static void StdFunction(benchmark::State &state) {
+      benchmark_allocations::Counter allocations(state);
+      auto arguments = makeArguments();
+      std::function<int(const AnyArguments &)> f = countArguments;
+      for (auto _ : state) {
+        benchmark::DoNotOptimize(arguments);
+        benchmark::DoNotOptimize(f(arguments));
+      }
+    }
+
+    static void AnyFunctionArguments(benchmark::State &state) {
+      benchmark_allocations::Counter allocations(state);
+      auto arguments = makeArguments();
+      AnyFunction f = countArguments;
+      for (auto _ : state) {
+        benchmark::DoNotOptimize(arguments);
+        benchmark::DoNotOptimize(f.call(arguments));
+      }
+    }
+  };
+
+  // ---- creation, copies and errors ----
+
+  using BinaryFunction = Function<Scalar, int, std::index_sequence<0, 1>>;
+
+  void CreateStdFunction(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    for (auto _ : state) {
+      BinaryFunction::StdFunction f = BinaryFunction();
+      benchmark::DoNotOptimize(f);
+    }
+  }
+
+  void CreateVirtual(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    for (auto _ : state) {
+      std::unique_ptr<BinaryFunction::Interface> f
+          = std::make_unique<BinaryFunction::Implementation>();
+      benchmark::DoNotOptimize(f);
+    }
+  }
+
+  void CreateAnyFunction(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    for (auto _ : state) {
+      AnyFunction f = BinaryFunction();
+      benchmark::DoNotOptimize(f);
+    }
+  }
+
+  void CopyStdFunction(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    BinaryFunction::StdFunction f = BinaryFunction();
+    for (auto _ : state) {
+      auto copy = f;
+      benchmark::DoNotOptimize(copy);
+    }
+  }
+
+  /**
+   * Virtual functions are usually shared through a `std::shared_ptr`.
+   */
+  void CopyVirtual(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    std::shared_ptr<BinaryFunction::Interface> f
+        = std::make_shared<BinaryFunction::Implementation>();
+    for (auto _ : state) {
+      auto copy = f;
+      benchmark::DoNotOptimize(copy);
+    }
+  }
+
+  void CopyAnyFunction(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    AnyFunction f = BinaryFunction();
+    for (auto _ : state) {
+      auto copy = f;
+      benchmark::DoNotOptimize(copy);
+    }
+  }
+
+  void ArityMismatchAnyFunction(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    AnyFunction f = BinaryFunction();
+    auto arguments = revisited::makeAnyArguments(1);
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(arguments);
+      try {
+        f.call(arguments);
+      } catch (const revisited::AnyFunctionInvalidArgumentCountException &) {
+      }
+    }
+  }
+
+  /**
+   * Statically typed calls cannot have the wrong number of arguments, so the error path is
+   * compared to throwing and catching an exception directly.
+   */
+  void ArityMismatchThrow(benchmark::State &state) {
+    benchmark_allocations::Counter allocations(state);
+    size_t count = 1;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(count);
+      try {
+        if (count != 2) {
+          throw revisited::AnyFunctionInvalidArgumentCountException();
+        }
+      } catch (const revisited::AnyFunctionInvalidArgumentCountException &) {
+      }
+    }
+  }
+
+  // ---- registration ----
+
+  using Benchmark = void (*)(benchmark::State &);
+  using Benchmarks = std::vector<std::pair<std::string, Benchmark>>;
+
+  void append(Benchmarks &result, const std::string &name, const Benchmarks &benchmarks) {
+    for (auto &[implementation, function] : benchmarks) {
+      result.emplace_back(name + "/" + implementation, function);
+    }
+  }
+
+  template <class Kind, class R, size_t... N>
+  Benchmarks callBenchmarks(const std::string &name, std::index_sequence<N...>) {
+    Benchmarks result;
+    (append(result, name + "/" + std::to_string(N),
+            {{"Direct", Calls<Kind, R, N>::Direct},
+             {"Virtual", Calls<Kind, R, N>::Virtual},
+             {"StdFunction", Calls<Kind, R, N>::StdFunction},
+             {"AnyFunction", Calls<Kind, R, N>::AnyFunctionCall},
+             {"AnyFunctionArguments", Calls<Kind, R, N>::AnyFunctionArguments}}),
+     ...);
+    return result;
+  }
+
+  template <size_t... N> Benchmarks variadicBenchmarks(std::index_sequence<N...>) {
+    Benchmarks result;
+    (append(result, "Variadic/" + std::to_string(N),
+            {{"Direct", VariadicCalls<N>::Direct},
+             {"Virtual", VariadicCalls<N>::Virtual},
+             {"StdFunction", VariadicCalls<N>::StdFunction},
+             {"AnyFunctionArguments", VariadicCalls<N>::AnyFunctionArguments}}),
+     ...);
+    return result;
+  }
+
+  bool registerBenchmarks(const std::vector<Benchmarks> &groups) {
+    for (auto &benchmarks : groups) {
+      for (auto &[name, function] : benchmarks) {
+        benchmark_perf_counters::registerBenchmark("AnyFunction/" + name, function);
+      }
+    }
+    return true;
+  }
+
+  using ArgumentCounts = std::make_index_sequence<MAX_ARGUMENTS + 1>;
+
+  const bool registered = registerBenchmarks({
+      {{"Create/StdFunction", CreateStdFunction},
+       {"Create/Virtual", CreateVirtual},
+       {"Create/AnyFunction", CreateAnyFunction},
+       {"Copy/StdFunction", CopyStdFunction},
+       {"Copy/Virtual", CopyVirtual},
+       {"Copy/AnyFunction", CopyAnyFunction}},
+      callBenchmarks<Scalar, int>("Call/Scalar", ArgumentCounts()),
+      callBenchmarks<Scalar, void>("CallVoid/Scalar", ArgumentCounts()),
+      callBenchmarks<String, int>("Call/String", ArgumentCounts()),
+      callBenchmarks<Reference, int>("Call/Reference", ArgumentCounts()),
+      callBenchmarks<AnyValue, int>("Call/Any", ArgumentCounts()),
+      variadicBenchmarks(ArgumentCounts()),
+      {{"ArityMismatch/AnyFunction", ArityMismatchAnyFunction},
+       {"ArityMismatch/Throw", ArityMismatchThrow}},
+  });
+
+}  // namespace any_function_benchmark
@@ -3,6 +3,8 @@
 
 #include <memory>
 
+#include "perf_counters.h"
+
 namespace classic {
   struct B;
   struct E;
@@ -162,11 +164,11 @@ static void DynamicCast(benchmark::State &state) {
   }
 }
 
-BENCHMARK(ClassicVisitor);
-BENCHMARK(Revisited);
-BENCHMARK(DynamicVisitor);
+BENCHMARK_WITH_PERF_COUNTERS(ClassicVisitor);
+BENCHMARK_WITH_PERF_COUNTERS(Revisited);
+BENCHMARK_WITH_PERF_COUNTERS(DynamicVisitor);
 
-BENCHMARK(VisitorCast);
-BENCHMARK(DynamicCast);
+BENCHMARK_WITH_PERF_COUNTERS(VisitorCast);
+BENCHMARK_WITH_PERF_COUNTERS(DynamicCast);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,252 @@
+#include <benchmark/benchmark.h>
+#include <revisited/visitor.h>
+#include <revisited/visitor_pointer_cast.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "perf_counters.h"
+
+/**
+ * Cast benchmarks for deep, wide and virtual hierarchies. Every hierarchy exists as revisited
+ * visitables and as classic polymorphic classes. Objects are cast from their base pointer to the
+ * farthest base type (root or last base) and to an unrelated type.
+ */
+
+namespace cast_benchmark {
+
+  using namespace revisited;
+
+  constexpr size_t DEPTH = 12;
+  constexpr size_t WIDTH = 8;
+  constexpr size_t DIAMONDS = 4;
+
+  struct Unrelated : public Visitable<Unrelated> {};
+
+  /**
+   * The polymorphic root of the classic hierarchies. Only the virtual and diamond hierarchies
+   * inherit it virtually, so that the deep and wide hierarchies measure plain inheritance.
+   */
+  struct ClassicObject {
+    virtual ~ClassicObject() {}
+  };
+
+  struct ClassicUnrelated : public ClassicObject {};
+
+  // ---- deep chain ----
+
+  template <size_t D> struct Deep : public DerivedVisitable<Deep<D>, Deep<D - 1>> {};
+  template <> struct Deep<0> : public Visitable<Deep<0>> {};
+
+  template <size_t D> struct ClassicDeep : public ClassicDeep<D - 1> {};
+  template <> struct ClassicDeep<0> : public ClassicObject {};
+
+  // ---- deep chain with virtual bases ----
+
+  template <size_t D> struct VirtualDeep
+      : public DerivedVisitable<VirtualDeep<D>, VirtualVisitable<VirtualDeep<D - 1>>> {};
+  template <> struct VirtualDeep<0> : public Visitable<VirtualDeep<0>> {};
+
+  template <size_t D> struct ClassicVirtualDeep : public virtual ClassicVirtualDeep<D - 1> {};
+  template <> struct ClassicVirtualDeep<0> : public virtual ClassicObject {};
+
+  // ---- wide ----
+
+  template <size_t I> struct WideBase : public Visitable<WideBase<I>> {};
+
+  template <class Indices> struct WideDefinition;
+  template <size_t... I> struct WideDefinition<std::index_sequence<I...>> {
+    struct type : public DerivedVisitable<type, JoinVisitable<WideBase<I>...>> {};
+  };
+  using Wide = WideDefinition<std::make_index_sequence<WIDTH>>::type;
+
+  template <size_t I> struct ClassicWideBase {
+    virtual ~ClassicWideBase() {}
+  };
+
+  template <class Indices> struct ClassicWideDefinition;
+  template <size_t... I> struct ClassicWideDefinition<std::index_sequence<I...>> {
+    struct type : public ClassicObject, public ClassicWideBase<I>... {};
+  };
+  using ClassicWide = ClassicWideDefinition<std::make_index_sequence<WIDTH>>::type;
+
+  // ---- stacked diamonds ----
+
+  template <size_t D> struct Diamond;
+  template <size_t D> struct DiamondLeft
+      : public DerivedVisitable<DiamondLeft<D>, VirtualVisitable<Diamond<D - 1>>> {};
+  template <size_t D> struct DiamondRight
+      : public DerivedVisitable<DiamondRight<D>, VirtualVisitable<Diamond<D - 1>>> {};
+  template <size_t D> struct Diamond
+      : public DerivedVisitable<Diamond<D>, VirtualVisitable<DiamondLeft<D>, DiamondRight<D>>> {
+  };
+  template <> struct Diamond<0> : public Visitable<Diamond<0>> {};
+
+  template <size_t D> struct ClassicDiamond;
+  template <size_t D> struct ClassicDiamondLeft : public virtual ClassicDiamond<D - 1> {};
+  template <size_t D> struct ClassicDiamondRight : public virtual ClassicDiamond<D - 1> {};
+  template <size_t D> struct ClassicDiamond : public virtual ClassicDiamondLeft<D>,
+                                              public virtual ClassicDiamondRight<D> {};
+  template <> struct ClassicDiamond<0> : public virtual ClassicObject {};
+
+  // ---- data visitables holding the classic hierarchies, used for value casts ----
+
+  template <template <size_t> class T, size_t... I>
+  TypeList<T<sizeof...(I) - 1 - I>...> reversedBases(std::index_sequence<I...>);
+
+  /**
+   * `T<N-1>, ..., T<0>`, ordered from the closest to the farthest base.
+   */
+  template <template <size_t> class T, size_t N> using ReversedBases
+      = decltype(reversedBases<T>(std::make_index_sequence<N>()));
+
+  template <size_t D> struct DiamondBases {
+    using type =
+        typename TypeList<ClassicDiamondLeft<D>, ClassicDiamondRight<D>, ClassicDiamond<D - 1>>::
+            template Merge<typename DiamondBases<D - 1>::type>;
+  };
+  template <> struct DiamondBases<0> { using type = TypeList<>; };
+
+  template <class T, class Bases> using Data
+      = DataVisitableWithBasesAndConversions<T, Bases, TypeList<>>;
+
+  using DeepData = Data<ClassicDeep<DEPTH - 1>, ReversedBases<ClassicDeep, DEPTH - 1>>;
+  using VirtualDeepData
+      = Data<ClassicVirtualDeep<DEPTH - 1>, ReversedBases<ClassicVirtualDeep, DEPTH - 1>>;
+  using WideData = Data<ClassicWide, ReversedBases<ClassicWideBase, WIDTH>>;
+  using DiamondData = Data<ClassicDiamond<DIAMONDS>, typename DiamondBases<DIAMONDS>::type>;
+
+  // ---- benchmarks ----
+
+  template <class Object, class Target> void VisitorCastPointer(benchmark::State &state) {
+    std::shared_ptr<VisitableBase> object = std::make_shared<Object>();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(object);
+      benchmark::DoNotOptimize(visitor_cast<Target *>(object.get()));
+    }
+  }
+
+  template <class Object, class Target> void VisitorCastReference(benchmark::State &state) {
+    std::shared_ptr<VisitableBase> object = std::make_shared<Object>();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(object);
+      try {
+        benchmark::DoNotOptimize(&visitor_cast<Target &>(*object));
+      } catch (const InvalidVisitorException &) {
+      }
+    }
+  }
+
+  template <class Object, class Target> void VisitorPointerCast(benchmark::State &state) {
+    std::shared_ptr<VisitableBase> object = std::make_shared<Object>();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(object);
+      benchmark::DoNotOptimize(visitor_pointer_cast<Target>(object));
+    }
+  }
+
+  template <class Object, class Target> void OptVisitorCast(benchmark::State &state) {
+    std::shared_ptr<VisitableBase> object = std::make_shared<Object>();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(object);
+      benchmark::DoNotOptimize(opt_visitor_cast<Target>(*object));
+    }
+  }
+
+  template <class Object, class Target> void DynamicCastPointer(benchmark::State &state) {
+    std::shared_ptr<ClassicObject> object = std::make_shared<Object>();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(object);
+      benchmark::DoNotOptimize(dynamic_cast<Target *>(object.get()));
+    }
+  }
+
+  template <class Object, class Target> void DynamicCastReference(benchmark::State &state) {
+    std::shared_ptr<ClassicObject> object = std::make_shared<Object>();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(object);
+      try {
+        benchmark::DoNotOptimize(&dynamic_cast<Target &>(*object));
+      } catch (const std::bad_cast &) {
+      }
+    }
+  }
+
+  template <class Object, class Target> void DynamicPointerCast(benchmark::State &state) {
+    std::shared_ptr<ClassicObject> object = std::make_shared<Object>();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(object);
+      benchmark::DoNotOptimize(std::dynamic_pointer_cast<Target>(object));
+    }
+  }
+
+  /**
+   * Value casts copy the target, so they are compared to a `dynamic_cast` followed by a copy.
+   */
+  template <class Object, class Target> void DynamicCastCopy(benchmark::State &state) {
+    std::shared_ptr<ClassicObject> object = std::make_shared<Object>();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(object);
+      std::optional<Target> result;
+      if (auto target = dynamic_cast<Target *>(object.get())) {
+        result = *target;
+      }
+      benchmark::DoNotOptimize(result);
+    }
+  }
+
+  // ---- registration ----
+
+  using Benchmark = void (*)(benchmark::State &);
+
+  struct Case {
+    std::string name;
+    std::vector<std::pair<const char *, Benchmark>> functions;
+  };
+
+  template <class Object, class Target, class Value, class Classic, class ClassicTarget>
+  std::vector<std::pair<const char *, Benchmark>> castBenchmarks() {
+    return {{"VisitorCastPointer", VisitorCastPointer<Object, Target>},
+            {"VisitorCastReference", VisitorCastReference<Object, Target>},
+            {"VisitorPointerCast", VisitorPointerCast<Object, Target>},
+            {"OptVisitorCast", OptVisitorCast<Value, ClassicTarget>},
+            {"DynamicCastPointer", DynamicCastPointer<Classic, ClassicTarget>},
+            {"DynamicCastReference", DynamicCastReference<Classic, ClassicTarget>},
+            {"DynamicPointerCast", DynamicPointerCast<Classic, ClassicTarget>},
+            {"DynamicCastCopy", DynamicCastCopy<Classic, ClassicTarget>}};
+  }
+
+  template <class Object, class Target, class Value, class Classic, class ClassicTarget>
+  std::vector<Case> hierarchyCases(const std::string &name) {
+    return {{name + "/success", castBenchmarks<Object, Target, Value, Classic, ClassicTarget>()},
+            {name + "/failure",
+             castBenchmarks<Object, Unrelated, Value, Classic, ClassicUnrelated>()}};
+  }
+
+  bool registerBenchmarks(const std::vector<std::vector<Case>> &hierarchies) {
+    for (auto &cases : hierarchies) {
+      for (auto &c : cases) {
+        for (auto &[name, function] : c.functions) {
+          benchmark_perf_counters::registerBenchmark("Cast/" + c.name + "/" + name, function);
+        }
+      }
+    }
+    return true;
+  }
+
+  const bool registered = registerBenchmarks({
+      hierarchyCases<Deep<DEPTH - 1>, Deep<0>, DeepData, ClassicDeep<DEPTH - 1>, ClassicDeep<0>>(
+          "Deep"),
+      hierarchyCases<VirtualDeep<DEPTH - 1>, VirtualDeep<0>, VirtualDeepData,
+                     ClassicVirtualDeep<DEPTH - 1>, ClassicVirtualDeep<0>>("VirtualDeep"),
+      hierarchyCases<Wide, WideBase<WIDTH - 1>, WideData, ClassicWide,
+                     ClassicWideBase<WIDTH - 1>>("Wide"),
+      hierarchyCases<Diamond<DIAMONDS>, Diamond<0>, DiamondData, ClassicDiamond<DIAMONDS>,
+                     ClassicDiamond<0>>("Diamond"),
+  });
+
+}  // namespace cast_benchmark
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+#include <revisited/visitable_collection.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "perf_counters.h"
+
+/**
+ * Visits all objects of a heterogeneous set of visitables, either stored as a shuffled vector of
+ * `std::shared_ptr`s that accept the visitor individually or in a `VisitableCollection` using
+ * `acceptAll`. The number of objects is given by the benchmark argument.
+ */
+
+namespace collection_benchmark {
+
+  using namespace revisited;
+
+  struct Node : public virtual VisitableBase {};
+
+  template <size_t I> struct Shape : public Node, public Visitable<Shape<I>> {
+    float position[3] = {float(I), 0, 0};
+  };
+
+  using Circle = Shape<0>;
+  using Square = Shape<1>;
+  using Triangle = Shape<2>;
+  using Polygon = Shape<3>;
+
+  struct SumVisitor : public Visitor<const Circle &, const Square &, const Triangle &,
+                                     const Polygon &> {
+    float sum = 0;
+    void visit(const Circle &s) override { sum += s.position[0]; }
+    void visit(const Square &s) override { sum += s.position[0]; }
+    void visit(const Triangle &s) override { sum += s.position[0]; }
+    void visit(const Polygon &s) override { sum += s.position[0]; }
+  };
+
+  template <class F> void forEachShape(size_t count, F &&f) {
+    for (size_t i = 0; i < count; ++i) {
+      switch (i % 4) {
+        case 0:
+          f(Circle());
+          break;
+        case 1:
+          f(Square());
+          break;
+        case 2:
+          f(Triangle());
+          break;
+        default:
+          f(Polygon());
+          break;
+      }
+    }
+  }
+
+  void Pointers(benchmark::State &state) {
+    std::vector<std::shared_ptr<const Node>> nodes;
+    forEachShape(size_t(state.range(0)), [&](auto shape) {
+      nodes.push_back(std::make_shared<decltype(shape)>(shape));
+    });
+    std::shuffle(nodes.begin(), nodes.end(), std::mt19937(42));
+    for (auto _ : state) {
+      SumVisitor visitor;
+      for (auto &node : nodes) {
+        node->accept(visitor);
+      }
+      benchmark::DoNotOptimize(visitor.sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void Collection(benchmark::State &state) {
+    VisitableCollection<Circle, Square, Triangle, Polygon> collection;
+    forEachShape(size_t(state.range(0)), [&](auto shape) { collection.insert(shape); });
+    const auto &shapes = collection;
+    for (auto _ : state) {
+      SumVisitor visitor;
+      shapes.acceptAll(visitor);
+      benchmark::DoNotOptimize(visitor.sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  const bool registered = []() {
+    for (auto [name, function] : {std::make_pair("Pointers", Pointers),
+                                  std::make_pair("Collection", Collection)}) {
+      benchmark_perf_counters::registerBenchmark(std::string("Collection/") + name, function)
+          ->RangeMultiplier(100)
+          ->Range(100, 1000000);
+    }
+    return true;
+  }();
+
+}  // namespace collection_benchmark
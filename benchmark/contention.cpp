@@ -0,0 +1,140 @@
+#include <benchmark/benchmark.h>
+#include <revisited/any_function.h>
+#include <revisited/versioned_any.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "perf_counters.h"
+
+/**
+ * Contention benchmarks: every thread copies, reads or calls the same `Any` or `AnyFunction`.
+ * Copies modify the shared reference count, so its cache line moves between the cores. Each
+ * benchmark is run with 1 up to the number of hardware threads and reports the total throughput as
+ * `items_per_second`. The `Local` variants use a separate object for every thread as a baseline.
+ */
+
+namespace contention_benchmark {
+
+  using revisited::Any;
+  using revisited::AnyFunction;
+
+  struct Value {
+    int data[8] = {};
+  };
+
+  Any makeAny() { return Value(); }
+
+  AnyFunction makeFunction() {
+    return [](int a, int b) { return a + b; };
+  }
+
+  const Any &sharedAny() {
+    static const Any any = makeAny();
+    return any;
+  }
+
+  const AnyFunction &sharedFunction() {
+    static const AnyFunction function = makeFunction();
+    return function;
+  }
+
+  revisited::VersionedAny &sharedVersionedAny() {
+    static revisited::VersionedAny any(makeAny());
+    return any;
+  }
+
+  /**
+   * Copies of `Any`s and `AnyFunction`s share their reference count, so the local baselines
+   * create a new object for every thread.
+   */
+  template <bool Shared> void CopyAny(benchmark::State &state) {
+    Any local = Shared ? Any() : makeAny();
+    const Any &any = Shared ? sharedAny() : local;
+    for (auto _ : state) {
+      Any copy = any;
+      benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  template <bool Shared> void ReadAny(benchmark::State &state) {
+    Any local = Shared ? Any() : makeAny();
+    const Any &any = Shared ? sharedAny() : local;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(any.get<const Value &>().data[0]);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  template <bool Shared> void CopyAnyFunction(benchmark::State &state) {
+    AnyFunction local = Shared ? AnyFunction() : makeFunction();
+    const AnyFunction &function = Shared ? sharedFunction() : local;
+    for (auto _ : state) {
+      AnyFunction copy = function;
+      benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  template <bool Shared> void CallAnyFunction(benchmark::State &state) {
+    AnyFunction local = Shared ? AnyFunction() : makeFunction();
+    const AnyFunction &function = Shared ? sharedFunction() : local;
+    auto arguments = revisited::makeAnyArguments(1, 2);
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(function.call(arguments));
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  /**
+   * Loads the value of a `VersionedAny`, which locks its mutex and copies the value.
+   */
+  void LoadVersionedAny(benchmark::State &state) {
+    auto &any = sharedVersionedAny();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(any.load());
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  /**
+   * Reads the value through a per-thread `VersionedAny::Snapshot`, which only loads the version
+   * while the value is unchanged.
+   */
+  void ReadVersionedAnySnapshot(benchmark::State &state) {
+    auto snapshot = sharedVersionedAny().snapshot();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(snapshot.get().get<const Value &>().data[0]);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  using Benchmark = void (*)(benchmark::State &);
+
+  bool registerBenchmarks(const std::vector<std::pair<std::string, Benchmark>> &benchmarks) {
+    int maxThreads = int(std::max(1u, std::thread::hardware_concurrency()));
+    for (auto &[name, function] : benchmarks) {
+      benchmark_perf_counters::registerBenchmark("Contention/" + name, function)
+          ->ThreadRange(1, maxThreads)
+          ->UseRealTime();
+    }
+    return true;
+  }
+
+  const bool registered = registerBenchmarks({
+      {"CopyAny/Shared", CopyAny<true>},
+      {"CopyAny/Local", CopyAny<false>},
+      {"ReadAny/Shared", ReadAny<true>},
+      {"ReadAny/Local", ReadAny<false>},
+      {"CopyAnyFunction/Shared", CopyAnyFunction<true>},
+      {"CopyAnyFunction/Local", CopyAnyFunction<false>},
+      {"CallAnyFunction/Shared", CallAnyFunction<true>},
+      {"CallAnyFunction/Local", CallAnyFunction<false>},
+      {"LoadVersionedAny/Shared", LoadVersionedAny},
+      {"ReadVersionedAnySnapshot/Shared", ReadVersionedAnySnapshot},
+  });
+
+}  // namespace contention_benchmark
@@ -0,0 +1,333 @@
+#include <benchmark/benchmark.h>
+#include <revisited/visitor.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "perf_counters.h"
+
+/**
+ * Dispatch scaling benchmarks: a single object is visited by a visitor accepting `N` types, with
+ * the object's type at the first, middle or last position of the visitor's arguments, as well as
+ * hierarchies of increasing depth where only the root type is visited.
+ */
+
+namespace dispatch_benchmark {
+
+  // visitors with 128 arguments were dropped from the sweep, as they made GCC take over 26 minutes
+  // to compile this file
+  constexpr std::array<size_t, 7> ARGUMENT_COUNTS = {1, 2, 4, 8, 16, 32, 64};
+  constexpr std::array<size_t, 6> HIERARCHY_DEPTHS = {1, 2, 4, 8, 12, 16};
+
+  size_t matchPosition(size_t count, size_t position) {
+    return position == 0 ? 0 : position == 1 ? count / 2 : count - 1;
+  }
+
+  const char *positionName(size_t position) {
+    return position == 0 ? "first" : position == 1 ? "middle" : "last";
+  }
+
+  // ---- revisited ----
+
+  template <size_t I> struct Node : public revisited::Visitable<Node<I>> {
+    size_t value = I;
+  };
+
+  /**
+   * Implements `visit` for all nodes in a single class, as a chain of classes each overriding a
+   * single method would generate construction vtables cubic in the number of arguments. Methods
+   * without a matching argument type are regular members.
+   */
+#define NODE_VISIT(I)                          \
+  Result visit(Node<I> &node) {                \
+    result = node.value;                       \
+    return static_cast<Result>(true);          \
+  }
+#define NODE_VISIT_8(I)                                                                 \
+  NODE_VISIT(I) NODE_VISIT(I + 1) NODE_VISIT(I + 2) NODE_VISIT(I + 3) NODE_VISIT(I + 4) \
+      NODE_VISIT(I + 5) NODE_VISIT(I + 6) NODE_VISIT(I + 7)
+#define NODE_VISIT_64(I)                                                               \
+  NODE_VISIT_8(I) NODE_VISIT_8(I + 8) NODE_VISIT_8(I + 16) NODE_VISIT_8(I + 24)        \
+      NODE_VISIT_8(I + 32) NODE_VISIT_8(I + 40) NODE_VISIT_8(I + 48) NODE_VISIT_8(I + 56)
+
+  template <class Base, class Result> struct NodeVisitorImplementation : public Base {
+    size_t result = 0;
+    NODE_VISIT_64(0)
+  };
+
+#undef NODE_VISIT_64
+#undef NODE_VISIT_8
+#undef NODE_VISIT
+
+  template <template <class...> class Base, class Result, class Indices> struct NodeVisitor;
+  template <template <class...> class Base, class Result, size_t... I>
+  struct NodeVisitor<Base, Result, std::index_sequence<I...>>
+      : public NodeVisitorImplementation<Base<Node<I> &...>, Result> {
+    static_assert(sizeof...(I) <= 64);
+  };
+
+  template <size_t N> using RegularNodeVisitor
+      = NodeVisitor<revisited::Visitor, void, std::make_index_sequence<N>>;
+  template <size_t N> using RecursiveNodeVisitor
+      = NodeVisitor<revisited::RecursiveVisitor, bool, std::make_index_sequence<N>>;
+
+  template <size_t... I>
+  std::vector<std::unique_ptr<revisited::VisitableBase>> makeNodes(std::index_sequence<I...>) {
+    std::vector<std::unique_ptr<revisited::VisitableBase>> result;
+    (result.push_back(std::make_unique<Node<I>>()), ...);
+    return result;
+  }
+
+  template <class Visitor, size_t N> void RevisitedDispatch(benchmark::State &state,
+                                                            size_t position) {
+    auto nodes = makeNodes(std::make_index_sequence<N>());
+    revisited::VisitableBase &node = *nodes[matchPosition(N, position)];
+    Visitor visitor;
+    for (auto _ : state) {
+      node.accept(visitor);
+      benchmark::DoNotOptimize(visitor.result);
+    }
+  }
+
+  // ---- dynamic_cast chain ----
+
+  template <size_t... I>
+  size_t __attribute__((noinline)) getValueByCast(revisited::VisitableBase &base,
+                                                  std::index_sequence<I...>) {
+    size_t result = 0;
+    auto match = [&](auto *node) {
+      if (node) {
+        result = node->value;
+      }
+      return node != nullptr;
+    };
+    (match(dynamic_cast<Node<I> *>(&base)) || ...);
+    return result;
+  }
+
+  template <size_t N> void DynamicCastDispatch(benchmark::State &state, size_t position) {
+    auto nodes = makeNodes(std::make_index_sequence<N>());
+    revisited::VisitableBase &node = *nodes[matchPosition(N, position)];
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(getValueByCast(node, std::make_index_sequence<N>()));
+    }
+  }
+
+  // ---- classic double dispatch ----
+
+  constexpr size_t MAX_CLASSIC_TYPES = ARGUMENT_COUNTS.back();
+
+  template <size_t I> struct ClassicNode;
+
+  template <size_t I> struct ClassicVisitorFor {
+    virtual void visit(ClassicNode<I> &) = 0;
+    virtual ~ClassicVisitorFor() {}
+  };
+
+  template <class Indices> struct ClassicVisitorInterface;
+  template <size_t... I> struct ClassicVisitorInterface<std::index_sequence<I...>>
+      : public ClassicVisitorFor<I>... {};
+
+  using ClassicVisitor = ClassicVisitorInterface<std::make_index_sequence<MAX_CLASSIC_TYPES>>;
+
+  struct ClassicBase {
+    virtual void accept(ClassicVisitor &) = 0;
+    virtual ~ClassicBase() {}
+  };
+
+  template <size_t I> struct ClassicNode : public ClassicBase {
+    size_t value = I;
+    void accept(ClassicVisitor &visitor) override {
+      static_cast<ClassicVisitorFor<I> &>(visitor).visit(*this);
+    }
+  };
+
+  template <class Indices> struct ClassicNodeVisitorImplementation;
+  template <> struct ClassicNodeVisitorImplementation<std::index_sequence<>>
+      : public ClassicVisitor {
+    size_t result = 0;
+  };
+  template <size_t I, size_t... Rest>
+  struct ClassicNodeVisitorImplementation<std::index_sequence<I, Rest...>>
+      : public ClassicNodeVisitorImplementation<std::index_sequence<Rest...>> {
+    void visit(ClassicNode<I> &node) override { this->result = node.value; }
+  };
+
+  using ClassicNodeVisitor
+      = ClassicNodeVisitorImplementation<std::make_index_sequence<MAX_CLASSIC_TYPES>>;
+
+  template <size_t... I>
+  std::vector<std::unique_ptr<ClassicBase>> makeClassicNodes(std::index_sequence<I...>) {
+    std::vector<std::unique_ptr<ClassicBase>> result;
+    (result.push_back(std::make_unique<ClassicNode<I>>()), ...);
+    return result;
+  }
+
+  template <size_t N> void ClassicDispatch(benchmark::State &state, size_t position) {
+    auto nodes = makeClassicNodes(std::make_index_sequence<N>());
+    ClassicBase &node = *nodes[matchPosition(N, position)];
+    ClassicNodeVisitor visitor;
+    for (auto _ : state) {
+      node.accept(visitor);
+      benchmark::DoNotOptimize(visitor.result);
+    }
+  }
+
+  // ---- std::visit ----
+
+  template <size_t I> struct PlainNode {
+    size_t value = I;
+  };
+
+  template <class Indices> struct PlainVariant;
+  template <size_t... I> struct PlainVariant<std::index_sequence<I...>> {
+    using type = std::variant<PlainNode<I>...>;
+    static type make(size_t index) {
+      static const std::array<type, sizeof...(I)> values
+          = {type(std::in_place_index<I>, PlainNode<I>())...};
+      return values[index];
+    }
+  };
+
+  template <size_t N> void VariantDispatch(benchmark::State &state, size_t position) {
+    using Variant = PlainVariant<std::make_index_sequence<N>>;
+    auto node = Variant::make(matchPosition(N, position));
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(node);
+      benchmark::DoNotOptimize(std::visit([](auto &n) { return n.value; }, node));
+    }
+  }
+
+  // ---- hierarchy depth ----
+
+  template <size_t D> struct DeepNode
+      : public revisited::DerivedVisitable<DeepNode<D>, DeepNode<D - 1>> {};
+  template <> struct DeepNode<0> : public revisited::Visitable<DeepNode<0>> {
+    size_t value = 0;
+  };
+
+  template <class Base, class Result> struct RootVisitor : public Base {
+    size_t result = 0;
+    Result visit(DeepNode<0> &node) override {
+      result = node.value + 1;
+      return static_cast<Result>(true);
+    }
+  };
+
+  template <class Visitor, size_t D> void RevisitedDepth(benchmark::State &state) {
+    std::unique_ptr<revisited::VisitableBase> node = std::make_unique<DeepNode<D>>();
+    Visitor visitor;
+    for (auto _ : state) {
+      node->accept(visitor);
+      benchmark::DoNotOptimize(visitor.result);
+    }
+  }
+
+  struct ClassicDeepVisitor;
+
+  struct ClassicDeepBase {
+    virtual void accept(ClassicDeepVisitor &) = 0;
+    virtual ~ClassicDeepBase() {}
+  };
+
+  template <size_t D> struct ClassicDeepNode : public ClassicDeepNode<D - 1> {};
+  template <> struct ClassicDeepNode<0> : public ClassicDeepBase {
+    size_t value = 0;
+    void accept(ClassicDeepVisitor &visitor) override;
+  };
+
+  struct ClassicDeepVisitor {
+    size_t result = 0;
+    virtual void visit(ClassicDeepNode<0> &node) { result = node.value + 1; }
+    virtual ~ClassicDeepVisitor() {}
+  };
+
+  void ClassicDeepNode<0>::accept(ClassicDeepVisitor &visitor) { visitor.visit(*this); }
+
+  template <size_t D> void ClassicDepth(benchmark::State &state) {
+    std::unique_ptr<ClassicDeepBase> node = std::make_unique<ClassicDeepNode<D>>();
+    ClassicDeepVisitor visitor;
+    for (auto _ : state) {
+      node->accept(visitor);
+      benchmark::DoNotOptimize(visitor.result);
+    }
+  }
+
+  template <size_t D> void DynamicCastDepth(benchmark::State &state) {
+    std::unique_ptr<ClassicDeepBase> node = std::make_unique<ClassicDeepNode<D>>();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(node);
+      benchmark::DoNotOptimize(dynamic_cast<ClassicDeepNode<0> *>(node.get())->value);
+    }
+  }
+
+  // ---- registration ----
+
+  using DispatchBenchmark = void (*)(benchmark::State &, size_t);
+  using DepthBenchmark = void (*)(benchmark::State &);
+
+  template <class F> struct Implementations {
+    size_t size;
+    std::array<std::pair<const char *, F>, 5> functions;
+  };
+
+  template <size_t N> Implementations<DispatchBenchmark> dispatchBenchmarks() {
+    return {N,
+            {{{"Classic", ClassicDispatch<N>},
+              {"Revisited", RevisitedDispatch<RegularNodeVisitor<N>, N>},
+              {"RevisitedRecursive", RevisitedDispatch<RecursiveNodeVisitor<N>, N>},
+              {"DynamicCast", DynamicCastDispatch<N>},
+              {"Variant", VariantDispatch<N>}}}};
+  }
+
+  template <size_t D> Implementations<DepthBenchmark> depthBenchmarks() {
+    using Regular = RootVisitor<revisited::Visitor<DeepNode<0> &>, void>;
+    using Recursive = RootVisitor<revisited::RecursiveVisitor<DeepNode<0> &>, bool>;
+    return {D,
+            {{{"Classic", ClassicDepth<D>},
+              {"Revisited", RevisitedDepth<Regular, D>},
+              {"RevisitedRecursive", RevisitedDepth<Recursive, D>},
+              {"DynamicCast", DynamicCastDepth<D>},
+              {nullptr, nullptr}}}};
+  }
+
+  // registering through function pointers keeps the benchmark bodies out of the initializer
+  bool registerBenchmarks(const std::vector<Implementations<DispatchBenchmark>> &dispatch,
+                          const std::vector<Implementations<DepthBenchmark>> &depth) {
+    for (auto &implementations : dispatch) {
+      for (size_t position = 0; position < (implementations.size > 1 ? 3 : 1); ++position) {
+        for (auto &[name, function] : implementations.functions) {
+          auto benchmarkName = std::string("Dispatch/") + name + "/"
+                               + std::to_string(implementations.size) + "/"
+                               + positionName(position);
+          benchmark_perf_counters::registerBenchmark(benchmarkName, function, position);
+        }
+      }
+    }
+    for (auto &implementations : depth) {
+      for (auto &[name, function] : implementations.functions) {
+        if (function) {
+          auto benchmarkName
+              = std::string("Depth/") + name + "/" + std::to_string(implementations.size);
+          benchmark_perf_counters::registerBenchmark(benchmarkName, function);
+        }
+      }
+    }
+    return true;
+  }
+
+  template <size_t... I, size_t... J>
+  bool registerBenchmarks(std::index_sequence<I...>, std::index_sequence<J...>) {
+    return registerBenchmarks({dispatchBenchmarks<ARGUMENT_COUNTS[I]>()...},
+                              {depthBenchmarks<HIERARCHY_DEPTHS[J]>()...});
+  }
+
+  const bool registered
+      = registerBenchmarks(std::make_index_sequence<ARGUMENT_COUNTS.size()>(),
+                           std::make_index_sequence<HIERARCHY_DEPTHS.size()>());
+
+}  // namespace dispatch_benchmark
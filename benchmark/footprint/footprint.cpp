@@ -0,0 +1,207 @@
+#include <revisited/any_function.h>
+#include <revisited/visitor.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../allocations.h"
+
+/**
+ * Reports the memory footprint of visitables, visitors, `Any`s and `AnyFunction`s as tab
+ * separated tables. The object layout table splits the size of each type into its payload, the
+ * vtable pointer and padding of an equivalent polymorphic class and the additional overhead of
+ * revisited's bases, such as further vtable pointers of virtual bases. The heap table lists the
+ * bytes held by a value, including the `std::shared_ptr` control block and indirect allocations
+ * of the payload. Allocator overhead is not included.
+ */
+
+namespace footprint {
+
+  using namespace revisited;
+
+  struct Payload {
+    uint64_t value = 0;
+  };
+
+  /**
+   * A class with a vtable pointer, as used by classic polymorphic hierarchies.
+   */
+  template <size_t PayloadSize> struct Polymorphic {
+    virtual ~Polymorphic() {}
+    char payload[PayloadSize];
+  };
+
+  template <> struct Polymorphic<0> {
+    virtual ~Polymorphic() {}
+  };
+
+  struct Leaf : public Visitable<Leaf> {
+    Payload payload;
+  };
+
+  template <size_t D> struct Chain : public DerivedVisitable<Chain<D>, Chain<D - 1>> {};
+  template <> struct Chain<0> : public Visitable<Chain<0>> {
+    Payload payload;
+  };
+
+  struct JoinLeft : public Visitable<JoinLeft> {
+    Payload payload;
+  };
+  struct JoinRight : public Visitable<JoinRight> {
+    Payload payload;
+  };
+  struct Join : public DerivedVisitable<Join, JoinVisitable<JoinLeft, JoinRight>> {};
+
+  struct DiamondTop : public Visitable<DiamondTop> {
+    Payload payload;
+  };
+  struct DiamondLeft : public DerivedVisitable<DiamondLeft, VirtualVisitable<DiamondTop>> {};
+  struct DiamondRight : public DerivedVisitable<DiamondRight, VirtualVisitable<DiamondTop>> {};
+  struct Diamond
+      : public DerivedVisitable<Diamond, VirtualVisitable<DiamondLeft, DiamondRight>> {};
+
+  template <size_t I> struct Node : public Visitable<Node<I>> {};
+
+  /**
+   * Visitors are abstract until their `visit` methods are implemented, which does not change
+   * their size.
+   */
+  template <class Indices> struct NodeVisitorDefinition;
+  template <size_t... I> struct NodeVisitorDefinition<std::index_sequence<I...>> {
+    using type = Visitor<Node<I> &...>;
+  };
+  template <size_t N> using NodeVisitor =
+      typename NodeVisitorDefinition<std::make_index_sequence<N>>::type;
+
+  // ---- object layout ----
+
+  struct Layout {
+    std::string type;
+    size_t size;
+    size_t payload;
+    size_t vptr;
+    size_t bases;
+  };
+
+  template <class T, size_t PayloadSize> Layout layout(const std::string &name) {
+    size_t size = sizeof(T);
+    size_t vptr = sizeof(Polymorphic<PayloadSize>) - PayloadSize;
+    return Layout{name, size, PayloadSize, vptr, size - PayloadSize - vptr};
+  }
+
+  template <size_t... N> void addVisitorLayouts(std::vector<Layout> &result,
+                                                std::index_sequence<N...>) {
+    (result.push_back(
+         layout<NodeVisitor<size_t(1) << N>, 0>("Visitor<" + std::to_string(1 << N) + " args>")),
+     ...);
+  }
+
+  std::vector<Layout> layouts() {
+    std::vector<Layout> result{
+        layout<Polymorphic<sizeof(Payload)>, sizeof(Payload)>("Polymorphic"),
+        layout<Leaf, sizeof(Payload)>("Visitable"),
+        layout<Chain<1>, sizeof(Payload)>("DerivedVisitable depth 1"),
+        layout<Chain<2>, sizeof(Payload)>("DerivedVisitable depth 2"),
+        layout<Chain<4>, sizeof(Payload)>("DerivedVisitable depth 4"),
+        layout<Chain<8>, sizeof(Payload)>("DerivedVisitable depth 8"),
+        layout<Join, 2 * sizeof(Payload)>("JoinVisitable of 2"),
+        layout<DiamondLeft, sizeof(Payload)>("VirtualVisitable"),
+        layout<Diamond, sizeof(Payload)>("VirtualVisitable diamond"),
+    };
+    addVisitorLayouts(result, std::make_index_sequence<7>());
+    return result;
+  }
+
+  // ---- heap footprint ----
+
+  struct Heap {
+    std::string type;
+    size_t handle;
+    size_t object;
+    size_t bytes;
+    size_t allocations;
+  };
+
+  /**
+   * Measures the allocations of `create()`, which returns a handle of type `Handle` to an object
+   * of type `Object`. The first call is not measured, as it may initialize static data such as
+   * type names.
+   */
+  template <class Handle, class Object, class F> Heap heap(const std::string &name, F &&create) {
+    create();
+    auto bytes = benchmark_allocations::liveBytes();
+    auto allocations = benchmark_allocations::liveCount();
+    Handle handle = create();
+    bytes = benchmark_allocations::liveBytes() - bytes;
+    allocations = benchmark_allocations::liveCount() - allocations;
+    return Heap{name, sizeof(Handle), sizeof(Object), bytes, allocations};
+  }
+
+  template <class T> Heap sharedHeap(const std::string &name) {
+    return heap<std::shared_ptr<T>, T>("shared_ptr<" + name + ">",
+                                       []() { return std::make_shared<T>(); });
+  }
+
+  template <class T> Heap anyHeap(const std::string &name, T value = T()) {
+    return heap<Any, typename AnyVisitable<T>::type>("Any(" + name + ")",
+                                                     [&]() { return Any(value); });
+  }
+
+  template <class F> Heap functionHeap(const std::string &name, const F &f) {
+    return heap<AnyFunction, SpecificAnyFunction<int, int, int>>(
+        "AnyFunction(" + name + ")", [&]() { return AnyFunction(f); });
+  }
+
+  std::vector<Heap> heaps() {
+    static Payload referenced;
+    std::array<char, 32> captured{};
+    return {
+        sharedHeap<Leaf>("Visitable"),
+        sharedHeap<Chain<8>>("DerivedVisitable depth 8"),
+        sharedHeap<Diamond>("VirtualVisitable diamond"),
+        anyHeap<bool>("bool"),
+        anyHeap<char>("char"),
+        anyHeap<short int>("short"),
+        anyHeap<int>("int"),
+        anyHeap<long int>("long"),
+        anyHeap<long long int>("long long"),
+        anyHeap<float>("float"),
+        anyHeap<double>("double"),
+        anyHeap<long double>("long double"),
+        anyHeap<std::string>("short string", "short"),
+        anyHeap<std::string>("long string", std::string(64, 'x')),
+        anyHeap<Payload>("8 byte struct"),
+        anyHeap<std::shared_ptr<Payload>>("shared_ptr", std::make_shared<Payload>()),
+        anyHeap<std::reference_wrapper<Payload>>("reference_wrapper", std::ref(referenced)),
+        anyHeap<Leaf>("Visitable"),
+        functionHeap("lambda", [](int a, int b) { return a + b; }),
+        functionHeap("lambda with 32 byte capture",
+                     [captured](int a, int b) { return a + b + captured[0]; }),
+    };
+  }
+
+}  // namespace footprint
+
+int main() {
+  using namespace footprint;
+
+  std::cout << "type\tsize\tpayload\tvptr\tbases\n";
+  for (auto &l : layouts()) {
+    std::cout << l.type << '\t' << l.size << '\t' << l.payload << '\t' << l.vptr << '\t'
+              << l.bases << '\n';
+  }
+
+  std::cout << "\ntype\thandle\tobject\theap\tcontrol block and other\tallocations\n";
+  for (auto &h : heaps()) {
+    std::cout << h.type << '\t' << h.handle << '\t' << h.object << '\t' << h.bytes << '\t'
+              << h.bytes - h.object << '\t' << h.allocations << '\n';
+  }
+
+  return 0;
+}
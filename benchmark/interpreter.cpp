@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+
+#include "../examples/interpreter.h"
+#include "allocations.h"
+#include "perf_counters.h"
+
+/**
+ * Macro benchmark of the expression interpreter from the examples directory, which combines
+ * visitors, `Any` values and `AnyFunction` builtins. Generated programs consist of the given number
+ * of `let` statements with random expressions of arithmetic, comparisons, conditionals and builtin
+ * calls over previously defined variables. `items_per_second` is the number of AST nodes parsed
+ * or evaluated per second.
+ */
+
+namespace interpreter_benchmark {
+
+  class Generator {
+  private:
+    std::mt19937 random;
+    size_t variables = 0;
+
+    size_t choose(size_t count) {
+      return std::uniform_int_distribution<size_t>(0, count - 1)(random);
+    }
+
+    std::string leaf() {
+      if (variables > 0 && choose(3) > 0) {
+        return "v" + std::to_string(choose(variables));
+      }
+      return std::to_string(choose(100)) + "." + std::to_string(choose(10));
+    }
+
+    std::string operand(size_t depth) {
+      return depth == 0 ? leaf() : "(" + expression(depth) + ")";
+    }
+
+    std::string expression(size_t depth) {
+      if (depth == 0) {
+        return leaf();
+      }
+      auto a = operand(depth - 1);
+      auto b = operand(depth - 1);
+      switch (choose(8)) {
+        case 0:
+          return a + " + " + b;
+        case 1:
+          return a + " - " + b;
+        case 2:
+          return a + " * " + b;
+        case 3:
+          return a + " / (1 + abs(" + b + "))";
+        case 4:
+          return "if (" + a + " < " + b + ") " + b + " else -" + a;
+        case 5:
+          return "min(" + a + ", " + b + ")";
+        case 6:
+          return "max(" + a + ", " + b + ")";
+        default:
+          return "sqrt(abs(" + a + ")) + " + b;
+      }
+    }
+
+  public:
+    explicit Generator(unsigned seed) : random(seed) {}
+
+    std::string program(size_t statements) {
+      std::string result;
+      for (size_t i = 0; i < statements; ++i) {
+        auto value = expression(1 + choose(3));
+        result += "let v" + std::to_string(variables++) + " = " + value + ";\n";
+      }
+      return result;
+    }
+  };
+
+  std::string generate(size_t statements) { return Generator(42).program(statements); }
+
+  void Parse(benchmark::State &state) {
+    interpreter::Interpreter interpreter;
+    auto source = generate(size_t(state.range(0)));
+    auto nodes = interpreter.parse(source).nodes;
+    benchmark_allocations::Counter allocations(state);
+    for (auto _ : state) {
+      auto program = interpreter.parse(source);
+      benchmark::DoNotOptimize(program);
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(nodes));
+    state.SetBytesProcessed(state.iterations() * int64_t(source.size()));
+  }
+
+  void Evaluate(benchmark::State &state) {
+    interpreter::Interpreter interpreter;
+    auto program = interpreter.parse(generate(size_t(state.range(0))));
+    benchmark_allocations::Counter allocations(state);
+    for (auto _ : state) {
+      auto result = interpreter.run(program);
+      benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(program.nodes));
+  }
+
+  void ParseAndEvaluate(benchmark::State &state) {
+    interpreter::Interpreter interpreter;
+    auto source = generate(size_t(state.range(0)));
+    auto nodes = interpreter.parse(source).nodes;
+    benchmark_allocations::Counter allocations(state);
+    for (auto _ : state) {
+      auto result = interpreter.run(interpreter.parse(source));
+      benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(nodes));
+  }
+
+  template <class F> void registerBenchmark(const std::string &name, F function) {
+    benchmark_perf_counters::registerBenchmark("Interpreter/" + name, function)
+        ->RangeMultiplier(10)
+        ->Range(10, 10000);
+  }
+
+  const bool registered = []() {
+    registerBenchmark("Parse", Parse);
+    registerBenchmark("Evaluate", Evaluate);
+    registerBenchmark("ParseAndEvaluate", ParseAndEvaluate);
+    return true;
+  }();
+
+}  // namespace interpreter_benchmark
@@ -0,0 +1,98 @@
+#include "perf_counters.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+using namespace benchmark_perf_counters;
+
+#ifdef __linux__
+
+namespace {
+
+  struct EventType {
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+  };
+
+  const EventType EVENT_TYPES[] = {
+      {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+      {"icache-misses", PERF_TYPE_HW_CACHE,
+       PERF_COUNT_HW_CACHE_L1I | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+           | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+  };
+
+  int openEvent(const EventType &event) {
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = event.type;
+    attributes.config = event.config;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    return int(syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+  }
+
+  /**
+   * Warns once about every event that cannot be opened, so that missing counters are explained in
+   * the output.
+   */
+  void warnUnavailable(const EventType &event, int error) {
+    static std::atomic<bool> warned[sizeof(EVENT_TYPES) / sizeof(EventType)] = {};
+    if (!warned[&event - EVENT_TYPES].exchange(true)) {
+      std::cerr << "hardware counter " << event.name << " unavailable: " << std::strerror(error)
+                << std::endl;
+    }
+  }
+
+}  // namespace
+
+PerfCounters::PerfCounters(benchmark::State &_state) : state(_state) {
+  for (auto &type : EVENT_TYPES) {
+    int fd = openEvent(type);
+    if (fd < 0) {
+      warnUnavailable(type, errno);
+      continue;
+    }
+    events.push_back(Event{type.name, fd});
+  }
+  for (auto &event : events) {
+    ioctl(event.fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(event.fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (auto &event : events) {
+    ioctl(event.fd, PERF_EVENT_IOC_DISABLE, 0);
+  }
+  for (auto &event : events) {
+    uint64_t value = 0;
+    if (read(event.fd, &value, sizeof(value)) == sizeof(value)) {
+      state.counters[event.name]
+          = benchmark::Counter(double(value), benchmark::Counter::kAvgIterations);
+    }
+    close(event.fd);
+  }
+}
+
+#else
+
+PerfCounters::PerfCounters(benchmark::State &_state) : state(_state) {}
+
+PerfCounters::~PerfCounters() {}
+
+#endif
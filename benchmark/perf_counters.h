@@ -0,0 +1,53 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+namespace benchmark_perf_counters {
+
+  /**
+   * Counts instructions, cycles, branch mispredictions and instruction cache misses of the current
+   * thread using `perf_event_open` and reports them per iteration when leaving the scope. Events
+   * that are not supported by the system or not permitted, e.g. due to `perf_event_paranoid`, are
+   * omitted. On systems other than Linux no counters are reported.
+   */
+  class PerfCounters {
+  private:
+    struct Event {
+      const char *name;
+      int fd;
+    };
+
+    benchmark::State &state;
+    std::vector<Event> events;
+
+  public:
+    explicit PerfCounters(benchmark::State &state);
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+    ~PerfCounters();
+  };
+
+  /**
+   * Registers a benchmark calling `function(state, args...)` that reports hardware counters.
+   * The counters include the benchmark's setup, which is amortized over its iterations.
+   */
+  template <class F, class... Args>
+  benchmark::internal::Benchmark *registerBenchmark(const std::string &name, F function,
+                                                    Args... args) {
+    return benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State &state) {
+      PerfCounters counters(state);
+      function(state, args...);
+    });
+  }
+
+}  // namespace benchmark_perf_counters
+
+/**
+ * Same as `BENCHMARK(function)`, but reports hardware counters.
+ */
+#define BENCHMARK_WITH_PERF_COUNTERS(function)                  \
+  static auto *function##PerfCountersBenchmark [[maybe_unused]] \
+      = benchmark_perf_counters::registerBenchmark(#function, function)
@@ -0,0 +1,33 @@
+#include <iostream>
+
+#include "interpreter.h"
+
+int main() {
+  interpreter::Interpreter interpreter;
+
+  // builtins are AnyFunctions that receive and return Anys
+  interpreter.define("hypot", [](double a, double b) { return std::sqrt(a * a + b * b); });
+
+  auto program = interpreter.parse(R"(
+    let a = 3;
+    let b = -4;
+    let c = hypot(a, b);
+    let d = if (c < 10) max(a, abs(b)) * 2 else 0;
+    c + d / 4;
+  )");
+  std::cout << "parsed " << program.nodes << " nodes" << std::endl;
+  std::cout << "result = " << interpreter.run(program).get<double>() << std::endl;
+
+  // comparisons evaluate to bools
+  auto comparison = interpreter.parse("min(1, 2) == 1;");
+  std::cout << "min(1, 2) == 1: " << interpreter.run(comparison).get<bool>() << std::endl;
+
+  // errors are reported while parsing
+  try {
+    interpreter.parse("let x = y;");
+  } catch (const interpreter::ParseError &error) {
+    std::cout << "parse error: " << error.what() << std::endl;
+  }
+
+  return 0;
+}
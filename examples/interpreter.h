@@ -0,0 +1,424 @@
+#pragma once
+
+#include <revisited/any_function.h>
+#include <revisited/visitor.h>
+
+#include <cctype>
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * A small expression language built on revisited. AST nodes are `DerivedVisitable`s of
+ * `Expression`, evaluated by a visitor. Values are carried as `revisited::Any`s and builtin
+ * functions are `revisited::AnyFunction`s.
+ *
+ * ```
+ * program    := statement*
+ * statement  := 'let' name '=' expression ';' | expression ';'
+ * expression := 'if' '(' expression ')' expression 'else' expression | comparison
+ * comparison := sum (('<' | '==') sum)?
+ * sum        := product (('+' | '-') product)*
+ * product    := unary (('*' | '/') unary)*
+ * unary      := '-' unary | number | name | name '(' arguments ')' | '(' expression ')'
+ * ```
+ *
+ * Numbers are `double`s and comparisons result in `bool`s. The value of a program is the value
+ * of its last statement.
+ */
+
+namespace interpreter {
+
+  using revisited::Any;
+  using revisited::AnyFunction;
+
+  struct ParseError : public std::exception {
+    std::string message;
+    explicit ParseError(std::string _message) : message(std::move(_message)) {}
+    const char *what() const noexcept override { return message.c_str(); }
+  };
+
+  // ---- AST ----
+
+  struct Expression : public revisited::Visitable<Expression> {};
+
+  using ExpressionPtr = std::unique_ptr<Expression>;
+
+  struct Constant : public revisited::DerivedVisitable<Constant, Expression> {
+    Any value;
+    explicit Constant(Any _value) : value(std::move(_value)) {}
+  };
+
+  struct Variable : public revisited::DerivedVisitable<Variable, Expression> {
+    size_t slot;
+    explicit Variable(size_t _slot) : slot(_slot) {}
+  };
+
+  struct Assignment : public revisited::DerivedVisitable<Assignment, Expression> {
+    size_t slot;
+    ExpressionPtr value;
+    Assignment(size_t _slot, ExpressionPtr _value) : slot(_slot), value(std::move(_value)) {}
+  };
+
+  struct Negation : public revisited::DerivedVisitable<Negation, Expression> {
+    ExpressionPtr operand;
+    explicit Negation(ExpressionPtr _operand) : operand(std::move(_operand)) {}
+  };
+
+  enum class Operator { Add, Subtract, Multiply, Divide, Less, Equal };
+
+  struct Binary : public revisited::DerivedVisitable<Binary, Expression> {
+    Operator op;
+    ExpressionPtr left, right;
+    Binary(Operator _op, ExpressionPtr _left, ExpressionPtr _right)
+        : op(_op), left(std::move(_left)), right(std::move(_right)) {}
+  };
+
+  struct Conditional : public revisited::DerivedVisitable<Conditional, Expression> {
+    ExpressionPtr condition, then, otherwise;
+    Conditional(ExpressionPtr _condition, ExpressionPtr _then, ExpressionPtr _otherwise)
+        : condition(std::move(_condition)),
+          then(std::move(_then)),
+          otherwise(std::move(_otherwise)) {}
+  };
+
+  struct Call : public revisited::DerivedVisitable<Call, Expression> {
+    AnyFunction function;
+    std::vector<ExpressionPtr> arguments;
+    Call(AnyFunction _function, std::vector<ExpressionPtr> _arguments)
+        : function(std::move(_function)), arguments(std::move(_arguments)) {}
+  };
+
+  /**
+   * A parsed program. Variables are resolved to slots of the evaluation frame while parsing.
+   */
+  struct Program {
+    std::vector<ExpressionPtr> statements;
+    size_t slots = 0;
+    size_t nodes = 0;
+  };
+
+  // ---- evaluation ----
+
+  class Evaluator : public revisited::Visitor<const Constant &, const Variable &,
+                                              const Assignment &, const Negation &,
+                                              const Binary &, const Conditional &, const Call &> {
+  private:
+    std::vector<Any> frame;
+    Any result;
+
+  public:
+    explicit Evaluator(size_t slots) : frame(slots) {}
+
+    Any evaluate(const Expression &expression) {
+      expression.accept(*this);
+      return std::move(result);
+    }
+
+    void visit(const Constant &constant) override { result = constant.value; }
+
+    void visit(const Variable &variable) override { result = frame[variable.slot]; }
+
+    void visit(const Assignment &assignment) override {
+      frame[assignment.slot] = evaluate(*assignment.value);
+      result = frame[assignment.slot];
+    }
+
+    void visit(const Negation &negation) override {
+      result = -evaluate(*negation.operand).get<double>();
+    }
+
+    void visit(const Binary &binary) override {
+      auto left = evaluate(*binary.left).get<double>();
+      auto right = evaluate(*binary.right).get<double>();
+      switch (binary.op) {
+        case Operator::Add:
+          result = left + right;
+          break;
+        case Operator::Subtract:
+          result = left - right;
+          break;
+        case Operator::Multiply:
+          result = left * right;
+          break;
+        case Operator::Divide:
+          result = left / right;
+          break;
+        case Operator::Less:
+          result = left < right;
+          break;
+        case Operator::Equal:
+          result = left == right;
+          break;
+      }
+    }
+
+    void visit(const Conditional &conditional) override {
+      if (evaluate(*conditional.condition).get<bool>()) {
+        result = evaluate(*conditional.then);
+      } else {
+        result = evaluate(*conditional.otherwise);
+      }
+    }
+
+    void visit(const Call &call) override {
+      revisited::AnyArguments arguments;
+      arguments.reserve(call.arguments.size());
+      for (auto &argument : call.arguments) {
+        arguments.push_back(evaluate(*argument));
+      }
+      result = call.function.call(std::move(arguments));
+    }
+  };
+
+  // ---- parsing ----
+
+  class Parser {
+  private:
+    const std::unordered_map<std::string, AnyFunction> &builtins;
+    std::string_view source;
+    size_t position = 0;
+    std::unordered_map<std::string, size_t> variables;
+    size_t nodes = 0;
+
+    void skipWhitespace() {
+      while (position < source.size() && isSpace(source[position])) {
+        ++position;
+      }
+    }
+
+    bool atEnd() {
+      skipWhitespace();
+      return position == source.size();
+    }
+
+    bool peek(std::string_view token) {
+      skipWhitespace();
+      return source.substr(position, token.size()) == token;
+    }
+
+    bool accept(std::string_view token) {
+      if (peek(token)) {
+        position += token.size();
+        return true;
+      }
+      return false;
+    }
+
+    void expect(std::string_view token) {
+      if (!accept(token)) {
+        error("expected '" + std::string(token) + "'");
+      }
+    }
+
+    [[noreturn]] void error(const std::string &message) {
+      throw ParseError(message + " at position " + std::to_string(position));
+    }
+
+    static bool isSpace(char c) { return std::isspace(static_cast<unsigned char>(c)); }
+    static bool isDigit(char c) { return std::isdigit(static_cast<unsigned char>(c)); }
+    static bool isNameCharacter(char c) {
+      return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    std::string name() {
+      skipWhitespace();
+      auto start = position;
+      while (position < source.size() && isNameCharacter(source[position])) {
+        ++position;
+      }
+      if (start == position || isDigit(source[start])) {
+        error("expected name");
+      }
+      return std::string(source.substr(start, position - start));
+    }
+
+    /**
+     * Accepts a keyword that is not the prefix of a longer name.
+     */
+    bool keyword(std::string_view word) {
+      auto start = position;
+      if (accept(word) && (position == source.size() || !isNameCharacter(source[position]))) {
+        return true;
+      }
+      position = start;
+      return false;
+    }
+
+    template <class T, typename... Args> ExpressionPtr make(Args &&... args) {
+      ++nodes;
+      return std::make_unique<T>(std::forward<Args>(args)...);
+    }
+
+    ExpressionPtr number() {
+      auto start = position;
+      while (position < source.size() && (isDigit(source[position]) || source[position] == '.')) {
+        ++position;
+      }
+      return make<Constant>(Any(std::stod(std::string(source.substr(start, position - start)))));
+    }
+
+    ExpressionPtr unary() {
+      if (accept("-")) {
+        return make<Negation>(unary());
+      }
+      if (accept("(")) {
+        auto result = expression();
+        expect(")");
+        return result;
+      }
+      skipWhitespace();
+      if (position < source.size() && isDigit(source[position])) {
+        return number();
+      }
+      auto identifier = name();
+      if (accept("(")) {
+        auto builtin = builtins.find(identifier);
+        if (builtin == builtins.end()) {
+          error("unknown function '" + identifier + "'");
+        }
+        std::vector<ExpressionPtr> arguments;
+        if (!accept(")")) {
+          do {
+            arguments.push_back(expression());
+          } while (accept(","));
+          expect(")");
+        }
+        return make<Call>(builtin->second, std::move(arguments));
+      }
+      auto variable = variables.find(identifier);
+      if (variable == variables.end()) {
+        error("unknown variable '" + identifier + "'");
+      }
+      return make<Variable>(variable->second);
+    }
+
+    ExpressionPtr product() {
+      auto result = unary();
+      while (true) {
+        if (accept("*")) {
+          result = make<Binary>(Operator::Multiply, std::move(result), unary());
+        } else if (accept("/")) {
+          result = make<Binary>(Operator::Divide, std::move(result), unary());
+        } else {
+          return result;
+        }
+      }
+    }
+
+    ExpressionPtr sum() {
+      auto result = product();
+      while (true) {
+        if (accept("+")) {
+          result = make<Binary>(Operator::Add, std::move(result), product());
+        } else if (accept("-")) {
+          result = make<Binary>(Operator::Subtract, std::move(result), product());
+        } else {
+          return result;
+        }
+      }
+    }
+
+    ExpressionPtr comparison() {
+      auto result = sum();
+      if (accept("<")) {
+        return make<Binary>(Operator::Less, std::move(result), sum());
+      }
+      if (accept("==")) {
+        return make<Binary>(Operator::Equal, std::move(result), sum());
+      }
+      return result;
+    }
+
+    ExpressionPtr expression() {
+      skipWhitespace();
+      if (keyword("if")) {
+        expect("(");
+        auto condition = expression();
+        expect(")");
+        auto then = expression();
+        skipWhitespace();
+        if (!keyword("else")) {
+          error("expected 'else'");
+        }
+        return make<Conditional>(std::move(condition), std::move(then), expression());
+      }
+      return comparison();
+    }
+
+    ExpressionPtr statement() {
+      skipWhitespace();
+      if (keyword("let")) {
+        auto variable = name();
+        expect("=");
+        auto value = expression();
+        expect(";");
+        auto slot = variables.emplace(variable, variables.size()).first->second;
+        return make<Assignment>(slot, std::move(value));
+      }
+      auto result = expression();
+      expect(";");
+      return result;
+    }
+
+  public:
+    Parser(const std::unordered_map<std::string, AnyFunction> &_builtins, std::string_view _source)
+        : builtins(_builtins), source(_source) {}
+
+    Program parse() {
+      Program program;
+      while (!atEnd()) {
+        program.statements.push_back(statement());
+      }
+      program.slots = variables.size();
+      program.nodes = nodes;
+      return program;
+    }
+  };
+
+  /**
+   * Parses and runs programs using a set of builtin functions.
+   */
+  class Interpreter {
+  private:
+    std::unordered_map<std::string, AnyFunction> builtins;
+
+  public:
+    /**
+     * Creates an interpreter with the builtins `min`, `max`, `abs` and `sqrt`.
+     */
+    Interpreter() {
+      define("min", [](double a, double b) { return a < b ? a : b; });
+      define("max", [](double a, double b) { return a < b ? b : a; });
+      define("abs", [](double a) { return a < 0 ? -a : a; });
+      define("sqrt", [](double a) { return std::sqrt(a); });
+    }
+
+    /**
+     * Defines or replaces the builtin function `name`. Programs parsed afterwards call `function`.
+     */
+    void define(const std::string &name, AnyFunction function) {
+      builtins[name] = std::move(function);
+    }
+
+    Program parse(std::string_view source) const { return Parser(builtins, source).parse(); }
+
+    /**
+     * Evaluates the statements of `program` and returns the value of the last one.
+     */
+    Any run(const Program &program) const {
+      Evaluator evaluator(program.slots);
+      Any result;
+      for (auto &statement : program.statements) {
+        result = evaluator.evaluate(*statement);
+      }
+      return result;
+    }
+  };
+
+}  // namespace interpreter
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <revisited/any_instrumentation.h>
 #include <revisited/visitor.h>
 
+#include <atomic>
 #include <exception>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <typeinfo>
 #include <utility>
 
 namespace revisited {
@@ -21,6 +26,22 @@ namespace revisited {
 
   class Any;
 
+  /**
+   * A string with static storage duration, created by `literal`.
+   */
+  struct StringLiteral {
+    std::string_view value;
+  };
+
+  /**
+   * Marks a string literal to be stored in an `Any` without copying it. The `Any` references the
+   * array, so it must not be used for arrays that go out of scope. All `N - 1` characters are
+   * kept, including embedded null characters.
+   */
+  template <size_t N> constexpr StringLiteral literal(const char (&value)[N]) {
+    return StringLiteral{std::string_view(value, N - 1)};
+  }
+
   namespace any_detail {
     template <typename T> struct is_shared_ptr : std::false_type { using value_type = void; };
     template <typename T> struct is_shared_ptr<std::shared_ptr<T>> : std::true_type {
@@ -38,6 +59,84 @@ namespace revisited {
       operator T &() { return **this; }
       operator const T &() const { return **this; }
     };
+
+    /**
+     * Captures an rvalue, allowing receivers to move from the referenced object.
+     */
+    template <class T> struct MovedReference : public std::reference_wrapper<T> {
+      using std::reference_wrapper<T>::reference_wrapper;
+    };
+
+    /**
+     * Base class of the visitables that store values captured by reference.
+     */
+    struct CapturedReference {
+      /**
+       * Stores an owned copy of the referenced value in `target`. Values captured as rvalues are
+       * moved instead.
+       */
+      virtual void copyValue(Any &target) = 0;
+      virtual ~CapturedReference() {}
+    };
+
+    /**
+     * Stores a `StringLiteral` without copying it. It can be visited as a `std::string_view` and a
+     * `std::string` is only constructed when requested as `std::string` or `std::string &`.
+     * Afterwards, all casts refer to the constructed string.
+     */
+    class StringLiteralVisitable : public virtual VisitableBase, public IndirectVisitableBase {
+    private:
+      std::string_view literal;
+      mutable std::once_flag once;
+      mutable std::atomic<bool> materialized{false};
+      mutable std::string string;
+
+      std::string &materialize() const {
+        std::call_once(once, [this]() {
+          string = literal;
+          materialized.store(true, std::memory_order_release);
+        });
+        return string;
+      }
+
+    public:
+      using Type = StringLiteralVisitable;
+      using Types = TypeList<std::string &, const std::string &, std::string_view, std::string>;
+      using ConstTypes = TypeList<const std::string &, std::string_view, std::string>;
+
+      explicit StringLiteralVisitable(StringLiteral value) : literal(value.value) {}
+
+      void accept(VisitorBase &visitor) override { visit(this, Types(), visitor); }
+
+      void accept(VisitorBase &visitor) const override { visit(this, ConstTypes(), visitor); }
+
+      bool accept(RecursiveVisitorBase &visitor) override { return visit(this, Types(), visitor); }
+
+      bool accept(RecursiveVisitorBase &visitor) const override {
+        return visit(this, ConstTypes(), visitor);
+      }
+
+      TypeID visitableType() const override { return getTypeID<std::string>(); }
+
+      template <typename O> O cast() const {
+        if constexpr (std::is_same<O, std::string_view>::value) {
+          if (materialized.load(std::memory_order_acquire)) {
+            return string;
+          }
+          return literal;
+        } else {
+          return static_cast<O>(std::as_const(materialize()));
+        }
+      }
+
+      template <typename O> O cast() {
+        if constexpr (std::is_same<O, std::string &>::value) {
+          return materialize();
+        } else {
+          return std::as_const(*this).template cast<O>();
+        }
+      }
+    };
   }  // namespace any_detail
 
   /**
@@ -46,14 +145,48 @@ namespace revisited {
   class Any {
   protected:
     std::shared_ptr<VisitableBase> data;
+    TypeIndex tag = getTypeIndex<void>();
+
+    void updateTag() { tag = data ? data->visitableType().index : getTypeIndex<void>(); }
+
+    template <class VisitableType> void recordAllocation() const {
+      if constexpr (any_instrumentation::enabled) {
+        any_instrumentation::recordAllocation(type(), sizeof(VisitableType));
+      }
+    }
+
+    template <class T> void recordCast(bool success) const {
+      if constexpr (any_instrumentation::enabled) {
+        using Target = typename any_detail::remove_cvref<T>::type;
+        any_instrumentation::recordCast(type(), getTypeID<Target>(), success);
+      }
+    }
+
+    /**
+     * Returns a pointer to the stored value if it is stored as `VisitableType` and not shared with
+     * other `Any`s, otherwise `nullptr`.
+     */
+    template <class T, class VisitableType = typename AnyVisitable<T>::type>
+    T *tryGetOwned() const {
+      if (!data || data.use_count() != 1 || typeid(*data) != typeid(VisitableType)) {
+        return nullptr;
+      }
+      return &static_cast<T &>(*dynamic_cast<VisitableType *>(data.get()));
+    }
 
   public:
     Any() {}
-    Any(Any &&) = default;
+    Any(Any &&other) noexcept
+        : data(std::move(other.data)), tag(std::exchange(other.tag, getTypeIndex<void>())) {}
     Any(const Any &) = default;
-    Any &operator=(Any &&) = default;
     Any &operator=(const Any &) = default;
 
+    Any &operator=(Any &&other) noexcept {
+      data = std::move(other.data);
+      tag = std::exchange(other.tag, getTypeIndex<void>());
+      return *this;
+    }
+
     template <class T, typename = typename std::enable_if<any_detail::NotDerivedFromAny<T>>::type>
     Any(T &&v) {
       set<typename any_detail::remove_cvref<T>::type>(std::forward<T>(v));
@@ -85,14 +218,34 @@ namespace revisited {
           data = value;
         } else {
           data = std::make_shared<VisitableType>(value);
+          recordAllocation<VisitableType>();
         }
+        updateTag();
       } else {
         auto value = std::make_shared<VisitableType>(std::forward<Args>(args)...);
         data = value;
+        tag = value->visitableType().index;
+        recordAllocation<VisitableType>();
         return static_cast<typename VisitableType::Type &>(*value);
       }
     }
 
+    /**
+     * Same as `Any::set<T>`, but if the `Any` already holds an exclusively owned `T`, the new
+     * value is move-assigned to it instead of allocating new storage.
+     */
+    template <class T, typename... Args> decltype(auto) emplace(Args &&... args) {
+      static_assert(!any_detail::is_shared_ptr<T>::value);
+      if constexpr (std::is_move_assignable<T>::value
+                    && std::is_same<typename AnyVisitable<T>::type::Type, T>::value) {
+        if (auto value = tryGetOwned<T>()) {
+          *value = T(std::forward<Args>(args)...);
+          return *value;
+        }
+      }
+      return set<T>(std::forward<Args>(args)...);
+    }
+
     /**
      * Same as `Any::set`, but uses an internal type that can be visitor_casted to
      * the base types.
@@ -102,10 +255,32 @@ namespace revisited {
       return set<T, DataVisitableWithBases<T, Bases...>>(std::forward<Args>(args)...);
     }
 
+    /**
+     * Assigns `value` to the stored object if it is of the same type, stored by value and not
+     * shared with other `Any`s. Otherwise a new object is stored, as when using `operator=`.
+     * Repeatedly assigning values of the same type therefore does not allocate. Objects captured
+     * by reference or through a `std::shared_ptr` are replaced, never written to.
+     */
+    template <class T> void assign(T &&value) {
+      using Type = typename any_detail::remove_cvref<T>::type;
+      if constexpr (any_detail::NotDerivedFromAny<T> && std::is_assignable<Type &, T &&>::value) {
+        if constexpr (std::is_same<typename AnyVisitable<Type>::type::Type, Type>::value) {
+          if (auto target = tryGetOwned<Type>()) {
+            *target = std::forward<T>(value);
+            return;
+          }
+        }
+      }
+      *this = std::forward<T>(value);
+    }
+
     /**
      * Captures the value from another any object
      */
-    void setReference(const Any &other) { data = other.data; }
+    void setReference(const Any &other) {
+      data = other.data;
+      tag = other.tag;
+    }
 
     /**
      * Casts the internal data to `T` using `visitor_cast`.
@@ -121,19 +296,27 @@ namespace revisited {
         if (!data) {
           return std::nullopt;
         }
-        return std::shared_ptr<Value>(data, tryGet<Value>());
+        auto result = tryGet<Value>();
+        recordCast<Value>(result);
+        return std::shared_ptr<Value>(data, result);
       } else {
         if (!data) {
           return std::nullopt;
         }
-        return opt_visitor_cast<T>(*data);
+        auto result = opt_visitor_cast<T>(*data);
+        recordCast<T>(bool(result));
+        return result;
       }
     }
 
     template <class T> typename std::enable_if<std::is_reference<T>::value,
                                                typename std::remove_reference<T>::type *>::type
     as() const {
-      return tryGet<typename std::remove_reference<T>::type>();
+      auto result = tryGet<typename std::remove_reference<T>::type>();
+      if (data) {
+        recordCast<T>(result);
+      }
+      return result;
     }
 
     /**
@@ -148,11 +331,69 @@ namespace revisited {
       } else if constexpr (any_detail::is_shared_ptr<T>::value) {
         using Value = typename any_detail::is_shared_ptr<T>::value_type;
         return std::shared_ptr<Value>(data, &get<Value &>());
+      } else if constexpr (any_instrumentation::enabled) {
+        try {
+          T result = visitor_cast<T>(*data);
+          recordCast<T>(true);
+          return result;
+        } catch (const InvalidVisitorException &) {
+          recordCast<T>(false);
+          throw;
+        }
       } else {
         return visitor_cast<T>(*data);
       }
     }
 
+    /**
+     * Returns a pointer to the stored value if it is of type `T` and may be moved from, i.e. it is
+     * either exclusively owned by this `Any` or captured as an rvalue by `makeAnyArguments`.
+     * Otherwise `nullptr` is returned.
+     */
+    template <class T> T *tryGetMovable() {
+      using Owned = typename AnyVisitable<T>::type;
+      using Moved = typename AnyVisitable<any_detail::MovedReference<T>>::type;
+      static_assert(!std::is_const<T>::value);
+      if (!data) {
+        return nullptr;
+      }
+      if constexpr (std::is_same<typename Owned::Type, T>::value) {
+        if (auto value = tryGetOwned<T>()) {
+          return value;
+        }
+      }
+      if (typeid(*data) == typeid(Moved)) {
+        return &dynamic_cast<Moved *>(data.get())->data.get();
+      }
+      return nullptr;
+    }
+
+    /**
+     * Returns the stored value as `T` and resets the `Any`. If the value is movable as defined by
+     * `tryGetMovable`, it is moved out, otherwise it is converted as by `get<T>()`.
+     */
+    template <class T> T take() {
+      static_assert(!std::is_reference<T>::value);
+      using Type = typename std::remove_cv<T>::type;
+      if constexpr (std::is_same<Type, Any>::value) {
+        Any result = std::move(*this);
+        reset();
+        return result;
+      } else {
+        if constexpr (std::is_move_constructible<Type>::value
+                      && !any_detail::is_shared_ptr<Type>::value) {
+          if (auto value = tryGetMovable<Type>()) {
+            T result(std::move(*value));
+            reset();
+            return result;
+          }
+        }
+        T result = get<T>();
+        reset();
+        return result;
+      }
+    }
+
     /**
      * Casts the internal data to `T *` using `visitor_cast`.
      * `nullptr` will be returned if the cast is unsuccessful.
@@ -181,10 +422,27 @@ namespace revisited {
      */
     operator bool() const { return bool(data); }
 
+    /**
+     * If the value is captured by reference, e.g. through `std::reference_wrapper`, replaces it by
+     * an owned copy, so that the `Any` no longer depends on the lifetime of the referenced object.
+     * Rvalues captured by `makeAnyArguments` are moved instead. Throws an `InvalidVisitorException`
+     * if the referenced value can neither be copied nor moved.
+     */
+    void ownValue() {
+      if (auto reference = dynamic_cast<any_detail::CapturedReference *>(data.get())) {
+        Any copy;
+        reference->copyValue(copy);
+        *this = std::move(copy);
+      }
+    }
+
     /**
      * resets the value
      */
-    void reset() { data.reset(); }
+    void reset() {
+      data.reset();
+      tag = getTypeIndex<void>();
+    }
 
     /**
      * the type of the stored value
@@ -196,6 +454,35 @@ namespace revisited {
       return data->visitableType();
     }
 
+    /**
+     * The type index of the stored value, as in `type().index`, or the index of `void` if empty.
+     * The index is cached when the value is set, so it can be used to cheaply branch on the stored
+     * type, e.g. in a `switch` with `case getTypeIndex<T>():` labels.
+     */
+    TypeIndex typeTag() const { return tag; }
+
+    /**
+     * `true`, if the stored value is exactly of type `T`, as reported by `type()`.
+     * Base classes and implicit conversions are not considered.
+     */
+    template <class T> bool is() const {
+      return tag == getTypeIndex<typename any_detail::remove_cvref<T>::type>();
+    }
+
+    /**
+     * `true`, if the stored value is of type `T` or can be accessed as a `T &` through the
+     * stored visitable, e.g. if `T` is a base class of the value. Unlike `is<T>`, this requires a
+     * visitor call unless the stored type matches `T` exactly.
+     */
+    template <class T> bool isA() const {
+      return is<T>() || tryGet<const typename any_detail::remove_cvref<T>::type>() != nullptr;
+    }
+
+    /**
+     * the internal visitable object or `nullptr`, if empty
+     */
+    VisitableBase *visitable() const { return data.get(); }
+
     /**
      * Accept visitor
      */
@@ -283,7 +570,21 @@ REVISITED_DEFINE_SCALAR_TYPE(double, REVISITED_NUMERIC_TYPES);
 REVISITED_DEFINE_SCALAR_TYPE(long double, REVISITED_NUMERIC_TYPES);
 
 /**
- * Char arrays are captured as strings.
+ * Strings can be visited as `std::string_view`s and vice versa.
+ */
+template <> struct revisited::AnyVisitable<std::string> {
+  using type = revisited::DataVisitableWithBasesAndConversions<
+      std::string, revisited::TypeList<>, revisited::TypeList<std::string_view>>;
+};
+
+template <> struct revisited::AnyVisitable<std::string_view> {
+  using type = revisited::DataVisitableWithBasesAndConversions<
+      std::string_view, revisited::TypeList<>, revisited::TypeList<std::string>>;
+};
+
+/**
+ * Char arrays are copied into strings. Use `revisited::literal` to reference string literals
+ * without copying them.
  */
 template <size_t N> struct revisited::AnyVisitable<char[N]> {
   using type = revisited::AnyVisitable<std::string>::type;
@@ -293,19 +594,65 @@ template <size_t N> struct revisited::AnyVisitable<const char[N]> {
   using type = revisited::AnyVisitable<std::string>::type;
 };
 
+template <> struct revisited::AnyVisitable<revisited::StringLiteral> {
+  using type = revisited::any_detail::StringLiteralVisitable;
+};
+
+namespace revisited::any_detail {
+
+  /**
+   * A data visitable storing the reference wrapper `Reference`, which can be copied by
+   * `Any::ownValue`.
+   */
+  template <class Reference, class Base> class CapturedReferenceVisitable
+      : public Base,
+        public CapturedReference {
+  public:
+    using Base::Base;
+
+    void copyValue(Any &target) override {
+      using Value = typename std::remove_const<typename Reference::type>::type;
+      constexpr bool isMoved = std::is_same<Reference, MovedReference<Value>>::value;
+      if constexpr (isMoved && std::is_move_constructible<Value>::value) {
+        target.set<Value>(std::move(this->data.get()));
+      } else if constexpr (std::is_copy_constructible<Value>::value) {
+        target.set<Value>(this->data.get());
+      } else {
+        throw InvalidVisitorException(this->visitableType(), getTypeID<TypeList<Value>>());
+      }
+    }
+  };
+
+}  // namespace revisited::any_detail
+
 /**
  * Capture values as reference through `std::reference_wrapper`.
  */
 template <class T> struct revisited::AnyVisitable<std::reference_wrapper<T>> {
-  using type = revisited::DataVisitablePrototype<
-      std::reference_wrapper<T>, typename AnyVisitable<T>::type::Types,
-      typename AnyVisitable<T>::type::ConstTypes, typename AnyVisitable<T>::type::Type>;
+  using type = revisited::any_detail::CapturedReferenceVisitable<
+      std::reference_wrapper<T>,
+      revisited::DataVisitablePrototype<std::reference_wrapper<T>,
+                                        typename AnyVisitable<T>::type::Types,
+                                        typename AnyVisitable<T>::type::ConstTypes,
+                                        typename AnyVisitable<T>::type::Type>>;
+};
+
+template <class T> struct revisited::AnyVisitable<revisited::any_detail::MovedReference<T>> {
+  using type = revisited::any_detail::CapturedReferenceVisitable<
+      revisited::any_detail::MovedReference<T>,
+      revisited::DataVisitablePrototype<revisited::any_detail::MovedReference<T>,
+                                        typename AnyVisitable<T>::type::Types,
+                                        typename AnyVisitable<T>::type::ConstTypes,
+                                        typename AnyVisitable<T>::type::Type>>;
 };
 
 template <class T> struct revisited::AnyVisitable<std::reference_wrapper<const T>> {
-  using type = revisited::DataVisitablePrototype<
-      std::reference_wrapper<const T>, typename AnyVisitable<T>::type::ConstTypes,
-      typename AnyVisitable<T>::type::ConstTypes, const typename AnyVisitable<T>::type::Type>;
+  using type = revisited::any_detail::CapturedReferenceVisitable<
+      std::reference_wrapper<const T>,
+      revisited::DataVisitablePrototype<std::reference_wrapper<const T>,
+                                        typename AnyVisitable<T>::type::ConstTypes,
+                                        typename AnyVisitable<T>::type::ConstTypes,
+                                        const typename AnyVisitable<T>::type::Type>>;
 };
 
 /**
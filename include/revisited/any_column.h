@@ -0,0 +1,131 @@
+#pragma once
+
+#include <revisited/any.h>
+
+#include <type_traits>
+#include <vector>
+
+namespace revisited {
+
+  /**
+   * A non-owning view of a contiguous array of values, used as an argument column for
+   * `AnyFunction::callBatch`. Columns of `Any` are supported as well.
+   */
+  class AnyColumn {
+  private:
+    void *values = nullptr;
+    size_t count = 0;
+    TypeID valueType = getTypeID<void>();
+    bool isConst = true;
+    Any (*getElement)(void *, size_t) = nullptr;
+
+    template <class T> void init(T *_values, size_t _count) {
+      using Value = typename std::remove_const<T>::type;
+      values = const_cast<Value *>(_values);
+      count = _count;
+      valueType = getTypeID<Value>();
+      isConst = std::is_const<T>::value;
+      getElement = [](void *v, size_t i) -> Any {
+        if constexpr (std::is_same<Value, Any>::value) {
+          return static_cast<const Any *>(v)[i];
+        } else {
+          return std::reference_wrapper<T>(static_cast<T *>(v)[i]);
+        }
+      };
+    }
+
+  public:
+    AnyColumn() = default;
+
+    template <class T> AnyColumn(T *values, size_t count) { init(values, count); }
+    template <class T> AnyColumn(std::vector<T> &values) { init(values.data(), values.size()); }
+    template <class T> AnyColumn(const std::vector<T> &values) {
+      init(values.data(), values.size());
+    }
+
+    size_t size() const { return count; }
+
+    /**
+     * the type of the referenced values
+     */
+    TypeID type() const { return valueType; }
+
+    /**
+     * Returns a pointer to the values if they are of type `T`, otherwise `nullptr`.
+     * A non-const `T` also requires the column to be mutable.
+     */
+    template <class T> T *data() const {
+      if (valueType != getTypeID<typename std::remove_const<T>::type>()
+          || (isConst && !std::is_const<T>::value)) {
+        return nullptr;
+      }
+      return static_cast<T *>(values);
+    }
+
+    /**
+     * Returns the `i`-th element captured by reference.
+     */
+    Any operator[](size_t i) const { return getElement(values, i); }
+  };
+
+  /**
+   * A non-owning view of a contiguous array of values that receives the results of
+   * `AnyFunction::callBatch`. A default constructed column discards the results.
+   */
+  class AnyResultColumn {
+  private:
+    void *values = nullptr;
+    size_t count = 0;
+    TypeID valueType = getTypeID<void>();
+    void (*setElement)(void *, size_t, Any &&) = nullptr;
+
+  public:
+    AnyResultColumn() = default;
+
+    template <class T> AnyResultColumn(T *_values, size_t _count)
+        : values(_values), count(_count), valueType(getTypeID<T>()) {
+      static_assert(!std::is_const<T>::value);
+      setElement = [](void *v, size_t i, Any &&value) {
+        if constexpr (std::is_same<T, Any>::value) {
+          static_cast<Any *>(v)[i] = std::move(value);
+        } else if constexpr (std::is_copy_constructible<T>::value
+                             && std::is_move_assignable<T>::value) {
+          static_cast<T *>(v)[i] = value.get<T>();
+        } else {
+          throw InvalidVisitorException(value.type(), getTypeID<TypeList<T>>());
+        }
+      };
+    }
+
+    template <class T> AnyResultColumn(std::vector<T> &values)
+        : AnyResultColumn(values.data(), values.size()) {}
+
+    size_t size() const { return count; }
+
+    /**
+     * the type of the referenced values
+     */
+    TypeID type() const { return valueType; }
+
+    /**
+     * Returns a pointer to the values if they are of type `T`, otherwise `nullptr`.
+     */
+    template <class T> T *data() const {
+      if (valueType != getTypeID<T>()) {
+        return nullptr;
+      }
+      return static_cast<T *>(values);
+    }
+
+    /**
+     * Converts `value` to the column's type and stores it at index `i`.
+     */
+    void set(size_t i, Any value) const { setElement(values, i, std::move(value)); }
+
+    /**
+     * `false`, if the results are discarded.
+     */
+    explicit operator bool() const { return setElement != nullptr; }
+  };
+
+}  // namespace revisited
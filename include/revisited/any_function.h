@@ -1,12 +1,19 @@
 #pragma once
 
 #include <revisited/any.h>
+#include <revisited/any_column.h>
 #include <revisited/make_function.h>
 
 #include <array>
+#include <atomic>
 #include <exception>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 namespace revisited {
@@ -27,14 +34,357 @@ namespace revisited {
     }
   };
 
+  /**
+   * Is raised when a any function is batch called with columns of different sizes
+   */
+  struct AnyFunctionInvalidBatchSizeException : public std::exception {
+    const char *what() const noexcept override {
+      return "called AnyFunction with columns of different sizes";
+    }
+  };
+
   class AnyArguments : public std::vector<AnyReference> {
     using std::vector<AnyReference>::vector;
   };
 
+  /**
+   * Describes how an `Any` argument is converted to a parameter type, from best to worst.
+   * `Promotion` is a numeric conversion that preserves all values of the stored type, such as
+   * `float` to `double`, while `Conversion` may narrow, such as `float` to `int`.
+   */
+  enum class ArgumentConversion { Exact, BaseCast, Promotion, Conversion, Generic, None };
+
+  namespace any_function_detail {
+    /**
+     * `true`, if every value of the arithmetic type `From` can be represented as a `To`.
+     */
+    template <class From, class To> constexpr bool isPromotion() {
+      if constexpr (!std::is_arithmetic<From>::value || !std::is_arithmetic<To>::value
+                    || std::is_same<From, bool>::value || std::is_same<To, bool>::value) {
+        return false;
+      } else if constexpr (std::is_floating_point<From>::value) {
+        return std::is_floating_point<To>::value
+               && std::numeric_limits<To>::digits >= std::numeric_limits<From>::digits
+               && std::numeric_limits<To>::max_exponent >= std::numeric_limits<From>::max_exponent;
+      } else if constexpr (std::is_floating_point<To>::value) {
+        return std::numeric_limits<To>::digits >= std::numeric_limits<From>::digits;
+      } else {
+        return (std::is_signed<To>::value || !std::is_signed<From>::value)
+               && std::numeric_limits<To>::digits >= std::numeric_limits<From>::digits;
+      }
+    }
+
+    template <class To, typename... From> bool isPromotion(TypeID type, TypeList<From...>) {
+      return ((type == getTypeID<From>() && isPromotion<From, To>()) || ...);
+    }
+
+    template <class T> ArgumentConversion getArgumentConversion(const Any &arg) {
+      using Type = typename any_detail::remove_cvref<T>::type;
+      if constexpr (std::is_same<Type, Any>::value) {
+        return ArgumentConversion::Generic;
+      } else if constexpr (std::is_reference<T>::value || any_detail::is_shared_ptr<Type>::value) {
+        using Target =
+            typename std::conditional<any_detail::is_shared_ptr<Type>::value,
+                                      typename any_detail::is_shared_ptr<Type>::value_type,
+                                      typename std::remove_reference<T>::type>::type;
+        if (!arg.tryGet<Target>()) {
+          return ArgumentConversion::None;
+        }
+        return arg.type() == getTypeID<typename std::remove_cv<Target>::type>()
+                   ? ArgumentConversion::Exact
+                   : ArgumentConversion::BaseCast;
+      } else {
+        if (!arg.as<Type>()) {
+          return ArgumentConversion::None;
+        } else if (arg.type() == getTypeID<Type>()) {
+          return ArgumentConversion::Exact;
+        } else if (arg.tryGet<const Type>()) {
+          return ArgumentConversion::BaseCast;
+        } else if (isPromotion<Type>(arg.type(), REVISITED_NUMERIC_TYPES())) {
+          return ArgumentConversion::Promotion;
+        } else {
+          return ArgumentConversion::Conversion;
+        }
+      }
+    }
+
+    /**
+     * `true`, if a `C` obtained from `visitable` through `visitor_cast` is at the same offset from
+     * the visitable for all visitables of the same dynamic type, i.e. it is the visitable itself,
+     * one of its bases or its data stored by value.
+     */
+    template <class C> bool hasFixedOffset(const VisitableBase *visitable) {
+      if (!dynamic_cast<const IndirectVisitableBase *>(visitable)) {
+        return true;
+      }
+      return dynamic_cast<const InlineVisitableData *>(visitable)
+             && visitable->visitableType() == getTypeID<typename std::remove_cv<C>::type>();
+    }
+
+    /**
+     * Provides contiguous access to a column of arguments for batch calls.
+     * Columns already holding the parameter type are accessed directly. Columns of `Any` whose
+     * values are all stored as the same visitable type at a fixed offset are read in place, after
+     * resolving the offset once for the column. Others are converted once into an internal buffer.
+     * Non-const references require a mutable column of the exact type.
+     */
+    template <class T> class BatchArgument {
+    private:
+      using Type = typename any_detail::remove_cvref<T>::type;
+      constexpr static bool isMutable
+          = std::is_rvalue_reference<T>::value
+            || (std::is_lvalue_reference<T>::value
+                && !std::is_const<typename std::remove_reference<T>::type>::value);
+      using Value = typename std::conditional<isMutable, Type, const Type>::type;
+      constexpr static bool isConvertible
+          = std::is_copy_constructible<Type>::value
+            && (!std::is_lvalue_reference<T>::value
+                || std::is_const<typename std::remove_reference<T>::type>::value);
+
+      std::vector<typename std::conditional<isConvertible, Type, char>::type> buffer;
+      Value *values;
+      const Any *rows = nullptr;
+      std::ptrdiff_t offset = 0;
+
+      /**
+       * Checks once for the whole column whether the rows of an `Any` column can be read in place.
+       */
+      bool readInPlace(const AnyColumn &column) {
+        auto anys = column.data<const Any>();
+        if (!anys || column.size() == 0) {
+          return false;
+        }
+        auto first = anys[0].visitable();
+        if (!first || !hasFixedOffset<const Type>(first)) {
+          return false;
+        }
+        auto &type = typeid(*first);
+        for (size_t i = 1; i < column.size(); ++i) {
+          auto visitable = anys[i].visitable();
+          if (!visitable || typeid(*visitable) != type) {
+            return false;
+          }
+        }
+        auto target = anys[0].tryGet<const Type>();
+        if (!target) {
+          return false;
+        }
+        rows = anys;
+        offset = reinterpret_cast<const char *>(target) - reinterpret_cast<const char *>(first);
+        return true;
+      }
+
+      const Type &row(size_t i) const {
+        auto base = reinterpret_cast<const char *>(rows[i].visitable());
+        return *reinterpret_cast<const Type *>(base + offset);
+      }
+
+    public:
+      BatchArgument(const AnyColumn &column)
+          : values(std::is_rvalue_reference<T>::value ? nullptr : column.data<Value>()) {
+        if (values) {
+          return;
+        }
+        if constexpr (!isMutable && !std::is_same<Type, Any>::value) {
+          if (readInPlace(column)) {
+            return;
+          }
+        }
+        if constexpr (isConvertible) {
+          buffer.reserve(column.size());
+          for (size_t i = 0; i < column.size(); ++i) {
+            buffer.push_back(column[i].get<Type>());
+          }
+          values = buffer.data();
+        } else {
+          throw InvalidVisitorException(column.type(), getTypeID<TypeList<T>>());
+        }
+      }
+
+      decltype(auto) operator[](size_t i) const {
+        if constexpr (std::is_rvalue_reference<T>::value) {
+          return std::move(values[i]);
+        } else if constexpr (isMutable) {
+          return static_cast<Value &>(values[i]);
+        } else {
+          return values ? static_cast<const Type &>(values[i]) : row(i);
+        }
+      }
+    };
+
+    template <class T> using Argument =
+        typename std::conditional<std::is_lvalue_reference<T>::value, T,
+                                  typename any_detail::remove_cvref<T>::type>::type;
+
+    /**
+     * Converts `arg` to the parameter type `T`. Rvalue reference parameters receive a copy.
+     */
+    template <class T> Argument<T> forwardArgument(const Any &arg) {
+      return arg.get<Argument<T>>();
+    }
+
+    /**
+     * Same as above, but moves into by-value and rvalue reference parameters if the argument is
+     * movable as defined by `Any::tryGetMovable`.
+     */
+    template <class T> Argument<T> forwardArgument(Any &arg) {
+      using Type = typename any_detail::remove_cvref<T>::type;
+      if constexpr (std::is_lvalue_reference<T>::value || any_detail::is_shared_ptr<Type>::value) {
+        return forwardArgument<T>(std::as_const(arg));
+      } else if constexpr (std::is_same<Type, Any>::value) {
+        return std::move(arg);
+      } else {
+        if (auto value = arg.tryGetMovable<Type>()) {
+          return std::move(*value);
+        }
+        return forwardArgument<T>(std::as_const(arg));
+      }
+    }
+
+    inline size_t getBatchSize(const std::vector<AnyColumn> &columns,
+                               const AnyResultColumn &results) {
+      auto rows = columns.empty() ? results.size() : columns[0].size();
+      for (auto &column : columns) {
+        if (column.size() != rows) {
+          throw AnyFunctionInvalidBatchSizeException();
+        }
+      }
+      if (results && results.size() != rows) {
+        throw AnyFunctionInvalidBatchSizeException();
+      }
+      return rows;
+    }
+
+    /**
+     * Stores the results of `f(i)` for all rows, writing directly to the result column if it holds
+     * values of type `R`.
+     */
+    template <class R, class F>
+    void storeBatchResults(size_t rows, const AnyResultColumn &results, const F &f) {
+      if constexpr (std::is_same<void, R>::value) {
+        for (size_t i = 0; i < rows; ++i) {
+          f(i);
+        }
+      } else {
+        using Value = typename any_detail::remove_cvref<R>::type;
+        if constexpr (std::is_move_assignable<Value>::value) {
+          if (auto output = results.data<Value>()) {
+            for (size_t i = 0; i < rows; ++i) {
+              output[i] = f(i);
+            }
+            return;
+          }
+        }
+        if (results) {
+          for (size_t i = 0; i < rows; ++i) {
+            results.set(i, f(i));
+          }
+        } else {
+          for (size_t i = 0; i < rows; ++i) {
+            f(i);
+          }
+        }
+      }
+    }
+
+    /**
+     * Stores the result of `f(0)` in the single result slot. `Any` slots are assigned using
+     * `Any::assign`, so that they can keep their allocation.
+     */
+    template <class R, class F> void storeResult(const AnyResultColumn &result, const F &f) {
+      using Value = typename any_detail::remove_cvref<R>::type;
+      if constexpr (!std::is_void<R>::value && !std::is_same<Value, Any>::value) {
+        if (auto output = result.data<Any>()) {
+          output->assign(f(0));
+          return;
+        }
+      }
+      storeBatchResults<R>(1, result, f);
+    }
+
+    /**
+     * Resolves the object argument of member pointer calls. Objects that are visitables themselves
+     * or that are stored by value as a `C` are at a fixed offset from the visitable for each
+     * dynamic visitable type. These offsets are cached, so the visitor is only used once per type.
+     * Other objects, such as captured references or values that convert to `C`, are resolved with
+     * `visitor_cast` on every call.
+     */
+    template <class C> class CachedObjectCast {
+    private:
+      struct Adjustment {
+        const std::type_info *type;
+        std::ptrdiff_t offset;
+        bool isFixed;
+      };
+
+      mutable std::atomic<const Adjustment *> last{nullptr};
+      mutable std::mutex mutex;
+      mutable std::vector<std::unique_ptr<const Adjustment>> adjustments;
+
+      static C &cast(const Any &object) {
+        if (auto target = object.tryGet<C>()) {
+          return *target;
+        }
+        throw InvalidVisitorException(object.type(), getTypeID<TypeList<C &>>());
+      }
+
+      static C &apply(const Adjustment &adjustment, const Any &object, VisitableBase *visitable) {
+        if (!adjustment.isFixed) {
+          return cast(object);
+        }
+        auto base = reinterpret_cast<char *>(visitable);
+        return *reinterpret_cast<C *>(base + adjustment.offset);
+      }
+
+      C &resolve(const Any &object, VisitableBase *visitable, const std::type_info &type) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto &adjustment : adjustments) {
+          if (*adjustment->type == type) {
+            last.store(adjustment.get(), std::memory_order_release);
+            return apply(*adjustment, object, visitable);
+          }
+        }
+        auto &target = cast(object);
+        auto adjustment = std::make_unique<Adjustment>();
+        adjustment->type = &type;
+        adjustment->isFixed = hasFixedOffset<C>(visitable);
+        adjustment->offset = reinterpret_cast<const char *>(&target)
+                             - reinterpret_cast<const char *>(visitable);
+        last.store(adjustment.get(), std::memory_order_release);
+        adjustments.emplace_back(std::move(adjustment));
+        return target;
+      }
+
+    public:
+      C &operator()(const Any &object) const {
+        auto visitable = object.visitable();
+        if (!visitable) {
+          throw UndefinedAnyException();
+        }
+        auto &type = typeid(*visitable);
+        auto adjustment = last.load(std::memory_order_acquire);
+        if (adjustment && *adjustment->type == type) {
+          return apply(*adjustment, object, visitable);
+        }
+        return resolve(object, visitable, type);
+      }
+    };
+  }  // namespace any_function_detail
+
   struct SpecificAnyFunctionBase {
     virtual Any call(const AnyArguments &args) const = 0;
+
+    /**
+     * Same as `call`, but may move from the arguments.
+     */
+    virtual Any callMovingArguments(AnyArguments &args) const { return call(args); }
+
+    virtual void callInto(const AnyArguments &args, const AnyResultColumn &result) const = 0;
+    virtual void callBatch(const std::vector<AnyColumn> &columns,
+                           const AnyResultColumn &results) const = 0;
     virtual TypeID returnType() const = 0;
     virtual TypeID argumentType(size_t) const = 0;
+    virtual ArgumentConversion argumentConversion(size_t, const Any &) const = 0;
     virtual size_t argumentCount() const = 0;
     virtual bool isVariadic() const = 0;
     virtual ~SpecificAnyFunctionBase() {}
@@ -47,25 +397,58 @@ namespace revisited {
   private:
     std::function<R(Args...)> callback;
 
-    template <size_t... Idx>
-    Any callWithArgumentIndices(const AnyArguments &args, std::index_sequence<Idx...>) const {
+    template <class A, size_t... Idx>
+    R callWithArgumentIndices(A &args, std::index_sequence<Idx...>) const {
+      return callback(any_function_detail::forwardArgument<Args>(args[Idx])...);
+    }
+
+    template <class A> Any callWithArguments(A &args) const {
+      if (args.size() != sizeof...(Args)) {
+        throw AnyFunctionInvalidArgumentCountException();
+      }
+      using Indices = std::make_index_sequence<sizeof...(Args)>;
       if constexpr (std::is_same<void, R>::value) {
-        callback(args[Idx].get<Args>()...);
+        callWithArgumentIndices(args, Indices());
         return Any();
       } else {
-        return callback(args[Idx].get<Args>()...);
+        return callWithArgumentIndices(args, Indices());
       }
     }
 
+    template <size_t... Idx>
+    void callBatchWithArgumentIndices(const std::vector<AnyColumn> &columns,
+                                      const AnyResultColumn &results,
+                                      std::index_sequence<Idx...>) const {
+      auto rows = any_function_detail::getBatchSize(columns, results);
+      std::tuple<any_function_detail::BatchArgument<Args>...> arguments{columns[Idx]...};
+      any_function_detail::storeBatchResults<R>(
+          rows, results,
+          [&]([[maybe_unused]] size_t i) -> R { return callback(std::get<Idx>(arguments)[i]...); });
+    }
+
   public:
     SpecificAnyFunction(std::function<R(Args...)> _callback) : callback(_callback) {}
 
-    Any call(const AnyArguments &args) const override {
+    Any call(const AnyArguments &args) const override { return callWithArguments(args); }
+
+    Any callMovingArguments(AnyArguments &args) const override { return callWithArguments(args); }
+
+    void callInto(const AnyArguments &args, const AnyResultColumn &result) const override {
       if (args.size() != sizeof...(Args)) {
         throw AnyFunctionInvalidArgumentCountException();
       }
       using Indices = std::make_index_sequence<sizeof...(Args)>;
-      return callWithArgumentIndices(args, Indices());
+      any_function_detail::storeResult<R>(
+          result, [&](size_t) -> R { return callWithArgumentIndices(args, Indices()); });
+    }
+
+    void callBatch(const std::vector<AnyColumn> &columns,
+                   const AnyResultColumn &results) const override {
+      if (columns.size() != sizeof...(Args)) {
+        throw AnyFunctionInvalidArgumentCountException();
+      }
+      using Indices = std::make_index_sequence<sizeof...(Args)>;
+      callBatchWithArgumentIndices(columns, results, Indices());
     }
 
     TypeID returnType() const override { return getTypeID<R>(); }
@@ -82,6 +465,16 @@ namespace revisited {
       }
     }
 
+    ArgumentConversion argumentConversion(size_t i, const Any &arg) const override {
+      if (i >= sizeof...(Args)) {
+        return ArgumentConversion::None;
+      } else {
+        std::array<ArgumentConversion (*)(const Any &), sizeof...(Args)> conversions{
+            &any_function_detail::getArgumentConversion<Args>...};
+        return conversions[i](arg);
+      }
+    }
+
     bool isVariadic() const override { return false; }
   };
 
@@ -102,26 +495,122 @@ namespace revisited {
       }
     }
 
+    void callInto(const AnyArguments &args, const AnyResultColumn &result) const override {
+      any_function_detail::storeResult<R>(result, [&](size_t) -> R { return callback(args); });
+    }
+
+    void callBatch(const std::vector<AnyColumn> &columns,
+                   const AnyResultColumn &results) const override {
+      auto rows = any_function_detail::getBatchSize(columns, results);
+      AnyArguments args(columns.size());
+      any_function_detail::storeBatchResults<R>(rows, results, [&](size_t i) -> R {
+        for (size_t j = 0; j < columns.size(); ++j) {
+          args[j] = columns[j][i];
+        }
+        return callback(args);
+      });
+    }
+
     TypeID returnType() const override { return getTypeID<R>(); }
 
     size_t argumentCount() const override { return 0; }
 
     TypeID argumentType(size_t) const override { return getTypeID<Any>(); }
 
+    ArgumentConversion argumentConversion(size_t, const Any &) const override {
+      return ArgumentConversion::Generic;
+    }
+
     bool isVariadic() const override { return true; }
   };
 
+  /**
+   * Calls a member function or reads a data member of the object passed as the first argument.
+   * Batch calls are forwarded to the base implementation.
+   */
+  template <class M, class R, class C, typename... Args> class SpecificMemberAnyFunction
+      : public SpecificAnyFunction<R, C, Args...> {
+  private:
+    M member;
+    any_function_detail::CachedObjectCast<typename std::remove_reference<C>::type> objectCast;
+
+    template <class A, size_t... Idx>
+    R callWithArgumentIndices(A &args, std::index_sequence<Idx...>) const {
+      return std::invoke(member, objectCast(args[0]),
+                         any_function_detail::forwardArgument<Args>(args[Idx + 1])...);
+    }
+
+    template <class A> Any callWithArguments(A &args) const {
+      if (args.size() != sizeof...(Args) + 1) {
+        throw AnyFunctionInvalidArgumentCountException();
+      }
+      using Indices = std::make_index_sequence<sizeof...(Args)>;
+      if constexpr (std::is_same<void, R>::value) {
+        callWithArgumentIndices(args, Indices());
+        return Any();
+      } else {
+        return callWithArgumentIndices(args, Indices());
+      }
+    }
+
+  public:
+    SpecificMemberAnyFunction(M _member)
+        : SpecificAnyFunction<R, C, Args...>(_member), member(_member) {}
+
+    Any call(const AnyArguments &args) const override { return callWithArguments(args); }
+
+    Any callMovingArguments(AnyArguments &args) const override { return callWithArguments(args); }
+
+    void callInto(const AnyArguments &args, const AnyResultColumn &result) const override {
+      if (args.size() != sizeof...(Args) + 1) {
+        throw AnyFunctionInvalidArgumentCountException();
+      }
+      using Indices = std::make_index_sequence<sizeof...(Args)>;
+      any_function_detail::storeResult<R>(
+          result, [&](size_t) -> R { return callWithArgumentIndices(args, Indices()); });
+    }
+  };
+
+  /**
+   * Captures the arguments as `AnyReference`s as done by `AnyFunction::operator()`.
+   * Values of types stored directly are captured by reference. Non-const rvalues are captured
+   * as movable, so that they can be moved into the parameters when calling with `AnyArguments &&`.
+   */
+  template <typename... Args> AnyArguments makeAnyArguments(Args &&... args) {
+    return AnyArguments{{[&]() {
+      using ArgType = typename any_detail::remove_cvref<Args>::type;
+      if constexpr (std::is_base_of<Any, ArgType>::value) {
+        return AnyReference(std::forward<Args>(args));
+      } else if constexpr (std::is_same<typename AnyVisitable<ArgType>::type::Type,
+                                        ArgType>::value) {
+        using Value = typename std::remove_reference<Args>::type;
+        if constexpr (std::is_lvalue_reference<Args>::value || std::is_const<Value>::value) {
+          return AnyReference(std::reference_wrapper<Value>(args));
+        } else {
+          return AnyReference(any_detail::MovedReference<Value>(args));
+        }
+      } else {
+        return AnyReference(std::forward<Args>(args));
+      }
+    }()}...};
+  }
+
   /**
    * Holds a functions of Any type.
    */
   class AnyFunction {
   private:
-    std::shared_ptr<SpecificAnyFunctionBase> specific;
+    std::shared_ptr<const SpecificAnyFunctionBase> specific;
 
     template <class R, typename... Args> void _set(const std::function<R(Args...)> &f) {
       specific = std::make_shared<SpecificAnyFunction<R, Args...>>(f);
     }
 
+    template <class M, class R, class C, typename... Args>
+    void _setMember(M member, std::function<R(C, Args...)> *) {
+      specific = std::make_shared<SpecificMemberAnyFunction<M, R, C, Args...>>(member);
+    }
+
   public:
     AnyFunction() = default;
     AnyFunction(const AnyFunction &) = default;
@@ -129,6 +618,12 @@ namespace revisited {
     AnyFunction &operator=(const AnyFunction &) = default;
     AnyFunction &operator=(AnyFunction &&) = default;
 
+    /**
+     * Creates an `AnyFunction` from a custom implementation.
+     */
+    explicit AnyFunction(std::shared_ptr<const SpecificAnyFunctionBase> f)
+        : specific(std::move(f)) {}
+
     template <typename F,
               typename = typename std::enable_if<!std::is_convertible<F, AnyFunction>::value>::type>
     AnyFunction(const F &f) {
@@ -142,9 +637,18 @@ namespace revisited {
       return *this;
     }
 
+    /**
+     * Sets the function to `f`. Member function and data member pointers receive the object as
+     * their first argument, which is resolved through `visitor_cast`. The resulting offsets are
+     * cached for each stored type, so subsequent calls do not need to visit the object.
+     */
     template <typename F> void set(const F &f) {
       static_assert(!std::is_convertible<F, AnyFunction>::value);
-      _set(make_function(f));
+      if constexpr (std::is_member_pointer<F>::value) {
+        _setMember(f, static_cast<make_function_type<F> *>(nullptr));
+      } else {
+        _set(make_function(f));
+      }
     }
 
     Any call(const AnyArguments &args) const {
@@ -154,24 +658,81 @@ namespace revisited {
       return specific->call(args);
     }
 
+    /**
+     * Same as above, but moves exclusively owned or rvalue-captured arguments into by-value and
+     * rvalue reference parameters.
+     */
+    Any call(AnyArguments &&args) const {
+      if (!specific) {
+        throw UndefinedAnyFunctionException();
+      }
+      return specific->callMovingArguments(args);
+    }
+
+    /**
+     * Calls the function with the arguments captured by `makeAnyArguments`. Rvalue arguments are
+     * moved into by-value and rvalue reference parameters.
+     */
     template <typename... Args> Any operator()(Args &&... args) const {
-      AnyArguments arguments{{[&]() {
-        using ArgType = typename any_detail::remove_cvref<Args>::type;
-        if constexpr (std::is_base_of<Any, ArgType>::value) {
-          return AnyReference(args);
-        } else if constexpr (std::is_same<typename AnyVisitable<ArgType>::type::Type,
-                                          ArgType>::value) {
-          return AnyReference(
-              std::reference_wrapper<typename std::remove_reference<Args>::type>(args));
-        } else {
-          return AnyReference(args);
-        }
-      }()}...};
-      return call(arguments);
+      return call(makeAnyArguments(std::forward<Args>(args)...));
+    }
+
+    /**
+     * Calls the function and writes the result to `result`, avoiding the allocation of a new
+     * `Any`. `result` may be of the return type, a type the result is converted to, or an `Any`
+     * whose stored object is assigned using `Any::assign`. For functions without return value,
+     * `result` is left unchanged.
+     */
+    template <class T> void callInto(const AnyArguments &args, T &result) const {
+      static_assert(!std::is_const<T>::value);
+      if (!specific) {
+        throw UndefinedAnyFunctionException();
+      }
+      specific->callInto(args, AnyResultColumn(&result, 1));
+    }
+
+    /**
+     * Calls the function asynchronously on `executor`, usually a `revisited::ThreadPool` from
+     * `<revisited/async.h>`. The arguments are moved into the scheduled task. Arguments captured
+     * by reference, e.g. by `makeAnyArguments` or through `std::reference_wrapper`, are replaced
+     * by owned copies using `Any::ownValue` before scheduling, so they may go out of scope before
+     * the call. Hence, non-const reference parameters refer to the copies. Use a `std::shared_ptr`
+     * to share objects with the call.
+     */
+    template <class Executor> auto callAsync(AnyArguments args, Executor &executor) const {
+      if (!specific) {
+        throw UndefinedAnyFunctionException();
+      }
+      for (auto &arg : args) {
+        arg.ownValue();
+      }
+      return executor.async([function = specific, args = std::move(args)]() mutable {
+        return function->callMovingArguments(args);
+      });
+    }
+
+    /**
+     * Calls the function once for every row of the argument columns and stores the results in
+     * `results`, which must have the same number of rows. Argument conversions are resolved once
+     * per column, so typed columns matching the parameter types avoid any per-row overhead.
+     */
+    void callBatch(const std::vector<AnyColumn> &columns,
+                   const AnyResultColumn &results = AnyResultColumn()) const {
+      if (!specific) {
+        throw UndefinedAnyFunctionException();
+      }
+      specific->callBatch(columns, results);
     }
 
     explicit operator bool() const { return bool(specific); }
 
+    /**
+     * The internal implementation, e.g. for wrapping it in a custom `SpecificAnyFunctionBase`.
+     */
+    const std::shared_ptr<const SpecificAnyFunctionBase> &specificFunction() const {
+      return specific;
+    }
+
     TypeID returnType() const {
       if (!specific) {
         throw UndefinedAnyFunctionException();
@@ -186,6 +747,16 @@ namespace revisited {
       return specific->argumentType(i);
     }
 
+    /**
+     * Returns how `arg` would be converted when passed as the `i`-th argument.
+     */
+    ArgumentConversion argumentConversion(size_t i, const Any &arg) const {
+      if (!specific) {
+        throw UndefinedAnyFunctionException();
+      }
+      return specific->argumentConversion(i, arg);
+    }
+
     size_t argumentCount() const {
       if (!specific) {
         throw UndefinedAnyFunctionException();
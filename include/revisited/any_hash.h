@@ -0,0 +1,146 @@
+#pragma once
+
+#include <revisited/any.h>
+
+#include <functional>
+#include <optional>
+#include <string>
+
+/**
+ * The types whose values can be hashed and compared through an `Any`.
+ * Define before including to support additional types.
+ */
+#ifndef REVISITED_HASHABLE_TYPES
+#  define REVISITED_HASHABLE_TYPES \
+    REVISITED_NUMERIC_TYPES::Push<bool, std::string>
+#endif
+
+namespace revisited {
+
+  namespace any_hash_detail {
+
+    template <class Base, typename... Types> struct HashVisitorImplementation;
+
+    template <class Base> struct HashVisitorImplementation<Base> : public Base {
+      size_t result = 0;
+      Any *copy = nullptr;
+      bool hash = true;
+    };
+
+    template <class Base, class T, typename... Rest>
+    struct HashVisitorImplementation<Base, T, Rest...>
+        : public HashVisitorImplementation<Base, Rest...> {
+      bool visit(const T &value) override {
+        if (this->hash) {
+          this->result = std::hash<T>()(value);
+        }
+        if (this->copy) {
+          *this->copy = value;
+        }
+        return true;
+      }
+    };
+
+    template <class Types> struct HashVisitor;
+    template <typename... Types> struct HashVisitor<TypeList<Types...>>
+        : public HashVisitorImplementation<RecursiveVisitor<const Types &...>, Types...> {};
+
+    template <class Base, typename... Types> struct EqualVisitorImplementation;
+
+    template <class Base> struct EqualVisitorImplementation<Base> : public Base {
+      const Any *other = nullptr;
+      bool result = false;
+    };
+
+    template <class Base, class T, typename... Rest>
+    struct EqualVisitorImplementation<Base, T, Rest...>
+        : public EqualVisitorImplementation<Base, Rest...> {
+      bool visit(const T &value) override {
+        auto otherValue = this->other->template tryGet<const T>();
+        this->result = otherValue && *otherValue == value;
+        return true;
+      }
+    };
+
+    template <class Types> struct EqualVisitor;
+    template <typename... Types> struct EqualVisitor<TypeList<Types...>>
+        : public EqualVisitorImplementation<RecursiveVisitor<const Types &...>, Types...> {};
+
+    /**
+     * Hashes the value and, if `copy` is provided, stores an owned copy of the value in `copy`.
+     */
+    inline std::optional<size_t> hashValue(const Any &v, Any *copy) {
+      if (!v) {
+        return 0;
+      }
+      HashVisitor<REVISITED_HASHABLE_TYPES> visitor;
+      visitor.copy = copy;
+      if (!v.accept(visitor)) {
+        return std::nullopt;
+      }
+      return visitor.result;
+    }
+
+    /**
+     * Stores an owned copy of the value in `copy` without hashing it.
+     * @return - `false`, if the type is not hashable
+     */
+    inline bool copyValue(const Any &v, Any &copy) {
+      if (!v) {
+        copy.reset();
+        return true;
+      }
+      HashVisitor<REVISITED_HASHABLE_TYPES> visitor;
+      visitor.copy = &copy;
+      visitor.hash = false;
+      return v.accept(visitor);
+    }
+
+  }  // namespace any_hash_detail
+
+  /**
+   * Returns the hash of the stored value or `std::nullopt` if its type is not one of
+   * `REVISITED_HASHABLE_TYPES`. Empty `Any`s have a hash of `0`.
+   */
+  inline std::optional<size_t> tryHashValue(const Any &v) {
+    return any_hash_detail::hashValue(v, nullptr);
+  }
+
+  /**
+   * Returns the hash of the stored value.
+   * Raises an `InvalidVisitorException` if the type is not hashable.
+   */
+  inline size_t hashValue(const Any &v) {
+    if (auto hash = tryHashValue(v)) {
+      return *hash;
+    }
+    throw InvalidVisitorException(v.type(), getTypeID<REVISITED_HASHABLE_TYPES>());
+  }
+
+  /**
+   * `true`, if both `Any`s are empty or hold equal values of the same hashable type.
+   */
+  inline bool equalValues(const Any &a, const Any &b) {
+    if (!a || !b) {
+      return !a && !b;
+    }
+    if (a.type() != b.type()) {
+      return false;
+    }
+    any_hash_detail::EqualVisitor<REVISITED_HASHABLE_TYPES> visitor;
+    visitor.other = &b;
+    return a.accept(visitor) && visitor.result;
+  }
+
+  /**
+   * Hash and equality functors for using `Any` values as keys in unordered containers.
+   */
+  struct AnyValueHash {
+    size_t operator()(const Any &v) const { return hashValue(v); }
+  };
+
+  struct AnyValueEqual {
+    bool operator()(const Any &a, const Any &b) const { return equalValues(a, b); }
+  };
+
+}  // namespace revisited
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <revisited/instrumentation.h>
+#include <revisited/type_index.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace revisited {
+
+  /**
+   * Allocation and cast counters for values stored in an `Any` of a specific type.
+   */
+  struct AnyTypeStatistics {
+    TypeID type;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    uint64_t exactCasts = 0;
+    uint64_t convertedCasts = 0;
+    uint64_t failedCasts = 0;
+  };
+
+  /**
+   * Counts the casts of stored values of type `source` to another type `target`.
+   */
+  struct AnyConversionStatistics {
+    TypeID source;
+    TypeID target;
+    uint64_t count = 0;
+    uint64_t failures = 0;
+  };
+
+  /**
+   * A snapshot of the instrumentation data of all threads.
+   * Types are sorted by their number of allocations and conversions by their count.
+   */
+  struct AnyStatistics {
+    std::vector<AnyTypeStatistics> types;
+    std::vector<AnyConversionStatistics> conversions;
+
+    /**
+     * Writes the statistics as tab separated tables.
+     */
+    void write(std::ostream &stream) const {
+      stream << "type\tallocations\tbytes\texact casts\tconverted casts\tfailed casts\n";
+      for (auto &t : types) {
+        stream << t.type.name << '\t' << t.allocations << '\t' << t.allocatedBytes << '\t'
+               << t.exactCasts << '\t' << t.convertedCasts << '\t' << t.failedCasts << '\n';
+      }
+      stream << "\nsource\ttarget\tcount\tfailures\n";
+      for (auto &c : conversions) {
+        stream << c.source.name << '\t' << c.target.name << '\t' << c.count << '\t' << c.failures
+               << '\n';
+      }
+    }
+  };
+
+  /**
+   * Opt-in instrumentation of `Any` allocations and casts. The hooks in `Any` are compiled out
+   * unless `REVISITED_ANY_INSTRUMENTATION` is defined, e.g. through the CMake option of the same
+   * name. The definition must be consistent across all translation units.
+   */
+  namespace any_instrumentation {
+
+#ifdef REVISITED_ANY_INSTRUMENTATION
+    constexpr bool enabled = true;
+#else
+    constexpr bool enabled = false;
+#endif
+
+    namespace detail {
+      struct Data {
+        std::unordered_map<TypeIndex, AnyTypeStatistics> types;
+        std::unordered_map<std::pair<TypeIndex, TypeIndex>, AnyConversionStatistics,
+                           instrumentation_detail::PairHash>
+            conversions;
+
+        AnyTypeStatistics &get(const TypeID &type) {
+          auto &result = types[type.index];
+          result.type = type;
+          return result;
+        }
+      };
+
+      using Recorder = instrumentation_detail::ThreadLocalRecorder<Data>;
+    }  // namespace detail
+
+    /**
+     * Records the allocation of a stored value of type `type`, using `bytes` bytes of storage.
+     */
+    inline void recordAllocation(const TypeID &type, size_t bytes) {
+      detail::Recorder::record([&](detail::Data &data) {
+        auto &stats = data.get(type);
+        stats.allocations++;
+        stats.allocatedBytes += bytes;
+      });
+    }
+
+    /**
+     * Records a cast of a stored value of type `source` to `target`.
+     */
+    inline void recordCast(const TypeID &source, const TypeID &target, bool success) {
+      detail::Recorder::record([&](detail::Data &data) {
+        auto &stats = data.get(source);
+        if (!success) {
+          stats.failedCasts++;
+        } else if (source == target) {
+          stats.exactCasts++;
+        } else {
+          stats.convertedCasts++;
+        }
+        if (source != target) {
+          auto &conversion = data.conversions[std::make_pair(source.index, target.index)];
+          conversion.source = source;
+          conversion.target = target;
+          conversion.count++;
+          conversion.failures += !success;
+        }
+      });
+    }
+
+    /**
+     * Merges the data recorded by all threads.
+     */
+    inline AnyStatistics snapshot() {
+      detail::Data merged;
+      detail::Recorder::forEach([&](const detail::Data &data) {
+        for (auto &[index, stats] : data.types) {
+          auto &target = merged.get(stats.type);
+          target.allocations += stats.allocations;
+          target.allocatedBytes += stats.allocatedBytes;
+          target.exactCasts += stats.exactCasts;
+          target.convertedCasts += stats.convertedCasts;
+          target.failedCasts += stats.failedCasts;
+        }
+        for (auto &[key, stats] : data.conversions) {
+          auto &target = merged.conversions[key];
+          target.source = stats.source;
+          target.target = stats.target;
+          target.count += stats.count;
+          target.failures += stats.failures;
+        }
+      });
+
+      AnyStatistics result;
+      for (auto &[index, stats] : merged.types) {
+        result.types.push_back(stats);
+      }
+      for (auto &[key, stats] : merged.conversions) {
+        result.conversions.push_back(stats);
+      }
+      std::sort(result.types.begin(), result.types.end(), [](auto &a, auto &b) {
+        return a.allocations != b.allocations ? a.allocations > b.allocations
+                                              : a.type.index < b.type.index;
+      });
+      std::sort(result.conversions.begin(), result.conversions.end(), [](auto &a, auto &b) {
+        if (a.count != b.count) {
+          return a.count > b.count;
+        }
+        return std::make_pair(a.source.index, a.target.index)
+               < std::make_pair(b.source.index, b.target.index);
+      });
+      return result;
+    }
+
+    /**
+     * Clears the data recorded by all threads.
+     */
+    inline void reset() { detail::Recorder::reset(); }
+
+  }  // namespace any_instrumentation
+
+}  // namespace revisited
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <revisited/any_function.h>
+
+#include <algorithm>
+#include <exception>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace revisited {
+
+  /**
+   * Is raised when no overload of an `AnyOverloadSet` accepts the arguments
+   */
+  struct NoMatchingOverloadException : public std::exception {
+    const char *what() const noexcept override { return "no matching overload for arguments"; }
+  };
+
+  /**
+   * The conversions required to call an overload with a specific combination of argument types.
+   */
+  struct ConversionPlan {
+    size_t overload;
+    std::vector<ArgumentConversion> conversions;
+
+    /**
+     * The total conversion cost. Lower is better.
+     */
+    size_t cost() const {
+      size_t result = 0;
+      for (auto conversion : conversions) {
+        result += static_cast<size_t>(conversion);
+      }
+      return result;
+    }
+  };
+
+  /**
+   * Holds multiple `AnyFunction`s that are called under a single name.
+   * When called, the overload with the cheapest argument conversions is selected, with earlier
+   * overloads winning ties. The selection is cached per combination of the arguments' internal
+   * visitable types, which also distinguish constness and the bases a value can be cast to.
+   * Calls may happen concurrently and only take a shared lock once the plan is cached, however
+   * overloads must not be added while calling.
+   */
+  class AnyOverloadSet {
+  private:
+    using Signature = std::vector<std::type_index>;
+
+    struct CachedPlan {
+      Signature signature;
+      std::optional<ConversionPlan> plan;
+    };
+
+    std::vector<AnyFunction> overloads;
+    // a node-based container, so that references to plans stay valid when inserting
+    mutable std::unordered_multimap<size_t, CachedPlan> plans;
+    mutable std::shared_mutex mutex;
+
+    static std::type_index visitableType(const Any &arg) {
+      if (auto visitable = arg.visitable()) {
+        return typeid(*visitable);
+      }
+      return typeid(void);
+    }
+
+    static size_t signatureHash(const AnyArguments &args) {
+      size_t result = args.size();
+      for (auto &arg : args) {
+        result ^= visitableType(arg).hash_code() + 0x9e3779b9 + (result << 6) + (result >> 2);
+      }
+      return result;
+    }
+
+    std::optional<ConversionPlan> createPlan(const AnyArguments &args) const {
+      std::optional<ConversionPlan> best;
+      for (size_t i = 0; i < overloads.size(); ++i) {
+        auto &overload = overloads[i];
+        if (!overload.isVariadic() && overload.argumentCount() != args.size()) {
+          continue;
+        }
+        ConversionPlan plan{i, {}};
+        plan.conversions.reserve(args.size());
+        for (size_t j = 0; j < args.size(); ++j) {
+          auto conversion = overload.argumentConversion(j, args[j]);
+          if (conversion == ArgumentConversion::None) {
+            break;
+          }
+          plan.conversions.push_back(conversion);
+        }
+        if (plan.conversions.size() == args.size() && (!best || plan.cost() < best->cost())) {
+          best = std::move(plan);
+        }
+      }
+      return best;
+    }
+
+    /**
+     * Returns the cached plan for the arguments or `nullptr`. Requires holding the mutex.
+     */
+    const std::optional<ConversionPlan> *cachedPlan(size_t hash, const AnyArguments &args) const {
+      auto range = plans.equal_range(hash);
+      for (auto it = range.first; it != range.second; ++it) {
+        auto &signature = it->second.signature;
+        if (signature.size() == args.size()
+            && std::equal(signature.begin(), signature.end(), args.begin(),
+                          [](auto &type, auto &arg) { return type == visitableType(arg); })) {
+          return &it->second.plan;
+        }
+      }
+      return nullptr;
+    }
+
+    const std::optional<ConversionPlan> &findPlan(const AnyArguments &args) const {
+      auto hash = signatureHash(args);
+      {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if (auto plan = cachedPlan(hash, args)) {
+          return *plan;
+        }
+      }
+      CachedPlan entry{{}, createPlan(args)};
+      entry.signature.reserve(args.size());
+      for (auto &arg : args) {
+        entry.signature.push_back(visitableType(arg));
+      }
+      std::unique_lock<std::shared_mutex> lock(mutex);
+      if (auto plan = cachedPlan(hash, args)) {
+        return *plan;
+      }
+      return plans.emplace(hash, std::move(entry))->second.plan;
+    }
+
+  public:
+    AnyOverloadSet() = default;
+    AnyOverloadSet(std::initializer_list<AnyFunction> functions) : overloads(functions) {}
+    AnyOverloadSet(const AnyOverloadSet &other) {
+      std::shared_lock<std::shared_mutex> lock(other.mutex);
+      overloads = other.overloads;
+      plans = other.plans;
+    }
+
+    AnyOverloadSet &operator=(const AnyOverloadSet &other) {
+      if (this != &other) {
+        std::unique_lock<std::shared_mutex> lock(mutex, std::defer_lock);
+        std::shared_lock<std::shared_mutex> otherLock(other.mutex, std::defer_lock);
+        std::lock(lock, otherLock);
+        overloads = other.overloads;
+        plans = other.plans;
+      }
+      return *this;
+    }
+
+    /**
+     * Adds an overload. Previously cached conversion plans are discarded.
+     */
+    void add(const AnyFunction &f) {
+      if (!f) {
+        throw UndefinedAnyFunctionException();
+      }
+      std::unique_lock<std::shared_mutex> lock(mutex);
+      overloads.push_back(f);
+      plans.clear();
+    }
+
+    size_t size() const { return overloads.size(); }
+
+    const AnyFunction &operator[](size_t i) const { return overloads[i]; }
+
+    /**
+     * Returns the conversion plan for the given arguments or `std::nullopt` if no overload
+     * accepts them.
+     */
+    std::optional<ConversionPlan> resolve(const AnyArguments &args) const {
+      return findPlan(args);
+    }
+
+    /**
+     * Calls the best matching overload.
+     * A `NoMatchingOverloadException` will be raised if no overload accepts the arguments.
+     */
+    Any call(const AnyArguments &args) const {
+      auto &plan = findPlan(args);
+      if (!plan) {
+        throw NoMatchingOverloadException();
+      }
+      return overloads[plan->overload].call(args);
+    }
+
+    template <typename... Args> Any operator()(Args &&... args) const {
+      return call(makeAnyArguments(std::forward<Args>(args)...));
+    }
+
+    /**
+     * Returns a variadic `AnyFunction` dispatching to this overload set.
+     */
+    AnyFunction function() const {
+      auto set = std::make_shared<AnyOverloadSet>(*this);
+      return [set](const AnyArguments &args) { return set->call(args); };
+    }
+  };
+
+}  // namespace revisited
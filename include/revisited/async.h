@@ -0,0 +1,352 @@
+#pragma once
+
+#include <revisited/any.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace revisited {
+
+  class ThreadPool;
+
+  namespace async_detail {
+
+    struct Task {
+      virtual void run() = 0;
+      virtual ~Task() {}
+    };
+
+    /**
+     * The shared state of an `AnyFuture`. Tasks derive from this class so that the callable and
+     * the state share a single allocation. Storing the result in an `Any` and registering
+     * continuations may allocate separately.
+     */
+    class FutureState : public Task {
+    private:
+      mutable std::mutex mutex;
+      mutable std::condition_variable condition;
+      bool ready = false;
+      Any result;
+      std::exception_ptr error;
+      std::vector<std::pair<std::shared_ptr<Task>, ThreadPool *>> continuations;
+
+      void finish();
+
+    public:
+      void setResult(Any &&value) {
+        result = std::move(value);
+        finish();
+      }
+
+      void setError(std::exception_ptr e) {
+        error = e;
+        finish();
+      }
+
+      bool isReady() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ready;
+      }
+
+      void wait() const;
+
+      /**
+       * Returns the result after the state is ready. Rethrows stored exceptions.
+       */
+      const Any &get() const {
+        wait();
+        if (error) {
+          std::rethrow_exception(error);
+        }
+        return result;
+      }
+
+      void addContinuation(std::shared_ptr<Task> task, ThreadPool &pool);
+    };
+
+    template <class F> class AsyncTask : public FutureState {
+    private:
+      F callback;
+
+    public:
+      template <class G> AsyncTask(G &&f) : callback(std::forward<G>(f)) {}
+
+      void run() override {
+        try {
+          if constexpr (std::is_same<void, decltype(callback())>::value) {
+            callback();
+            setResult(Any());
+          } else {
+            setResult(Any(callback()));
+          }
+        } catch (...) {
+          setError(std::current_exception());
+        }
+      }
+    };
+
+  }  // namespace async_detail
+
+  /**
+   * A handle to the `Any` result of an asynchronous call.
+   */
+  class AnyFuture {
+  private:
+    std::shared_ptr<async_detail::FutureState> state;
+
+  public:
+    AnyFuture() = default;
+    AnyFuture(std::shared_ptr<async_detail::FutureState> _state) : state(std::move(_state)) {}
+
+    /**
+     * `true`, when refering to an asynchronous call, `false` otherwise
+     */
+    bool valid() const { return bool(state); }
+
+    /**
+     * `true`, when the result is available
+     */
+    bool isReady() const { return state && state->isReady(); }
+
+    /**
+     * Blocks until the result is available.
+     * When called from a `ThreadPool` worker, pending tasks are executed while waiting.
+     */
+    void wait() const {
+      if (state) {
+        state->wait();
+      }
+    }
+
+    /**
+     * Waits for and returns the result. Exceptions raised by the call are rethrown.
+     * The result is returned by value, so it remains valid after the future is destroyed.
+     */
+    Any get() const {
+      if (!state) {
+        throw UndefinedAnyException();
+      }
+      return state->get();
+    }
+
+    /**
+     * Schedules `f` to be called with the result on `pool` once it is available.
+     * Exceptions are propagated to the returned future without calling `f`.
+     */
+    template <class F> AnyFuture then(F &&f, ThreadPool &pool) const;
+  };
+
+  /**
+   * A work-stealing thread pool. Each worker owns a task queue and steals from other workers
+   * when its own queue is empty. Tasks submitted from a worker are queued locally.
+   */
+  class ThreadPool {
+  private:
+    struct Worker {
+      std::mutex mutex;
+      std::deque<std::shared_ptr<async_detail::Task>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> nextWorker{0};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    bool stopping = false;
+
+    static ThreadPool *&currentPool() {
+      thread_local ThreadPool *pool = nullptr;
+      return pool;
+    }
+
+    static size_t &currentWorker() {
+      thread_local size_t index = 0;
+      return index;
+    }
+
+    std::shared_ptr<async_detail::Task> takeTask(size_t index) {
+      for (size_t i = 0; i < workers.size(); ++i) {
+        auto &worker = *workers[(index + i) % workers.size()];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.tasks.empty()) {
+          std::shared_ptr<async_detail::Task> task;
+          if (i == 0) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+          } else {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+          }
+          pending--;
+          return task;
+        }
+      }
+      return nullptr;
+    }
+
+    void work(size_t index) {
+      currentPool() = this;
+      currentWorker() = index;
+      while (true) {
+        if (auto task = takeTask(index)) {
+          task->run();
+          continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this]() { return pending > 0 || stopping; });
+        if (stopping && pending == 0) {
+          return;
+        }
+      }
+    }
+
+  public:
+    /**
+     * Creates a pool with `threadCount` workers. At least one worker is created.
+     */
+    explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency()) {
+      threadCount = std::max<size_t>(threadCount, 1);
+      for (size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(std::make_unique<Worker>());
+      }
+      for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([this, i]() { work(i); });
+      }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * Waits for all pending tasks to finish before joining the workers.
+     */
+    ~ThreadPool() {
+      {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+      }
+      sleepCondition.notify_all();
+      for (auto &thread : threads) {
+        thread.join();
+      }
+    }
+
+    /**
+     * A process-wide pool using all available cores.
+     */
+    static ThreadPool &global() {
+      static ThreadPool pool;
+      return pool;
+    }
+
+    /**
+     * The pool of the calling thread or `nullptr` if not called from a worker.
+     */
+    static ThreadPool *current() { return currentPool(); }
+
+    size_t size() const { return workers.size(); }
+
+    void submit(std::shared_ptr<async_detail::Task> task) {
+      auto index = currentPool() == this ? currentWorker() : nextWorker++ % workers.size();
+      {
+        auto &worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.emplace_back(std::move(task));
+        pending++;
+      }
+      { std::lock_guard<std::mutex> lock(sleepMutex); }
+      sleepCondition.notify_one();
+    }
+
+    /**
+     * Runs a single pending task on the calling thread.
+     * @return - `true`, if a task has been run
+     */
+    bool runPendingTask() {
+      auto index = currentPool() == this ? currentWorker() : 0;
+      if (auto task = takeTask(index)) {
+        task->run();
+        return true;
+      }
+      return false;
+    }
+
+    /**
+     * Calls `f` on a worker thread. The callable is stored in the same allocation as the shared
+     * state of the returned future.
+     */
+    template <class F> AnyFuture async(F &&f) {
+      auto task = std::make_shared<async_detail::AsyncTask<typename std::decay<F>::type>>(
+          std::forward<F>(f));
+      submit(task);
+      return AnyFuture(std::move(task));
+    }
+  };
+
+  namespace async_detail {
+
+    inline void FutureState::finish() {
+      decltype(continuations) pendingContinuations;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready = true;
+        pendingContinuations = std::move(continuations);
+      }
+      condition.notify_all();
+      for (auto &continuation : pendingContinuations) {
+        continuation.second->submit(std::move(continuation.first));
+      }
+    }
+
+    inline void FutureState::wait() const {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (!ready) {
+        if (auto pool = ThreadPool::current()) {
+          lock.unlock();
+          bool didRun = pool->runPendingTask();
+          lock.lock();
+          if (didRun) {
+            continue;
+          }
+          condition.wait_for(lock, std::chrono::milliseconds(1));
+        } else {
+          condition.wait(lock);
+        }
+      }
+    }
+
+    inline void FutureState::addContinuation(std::shared_ptr<Task> task, ThreadPool &pool) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ready) {
+          continuations.emplace_back(std::move(task), &pool);
+          return;
+        }
+      }
+      pool.submit(std::move(task));
+    }
+
+  }  // namespace async_detail
+
+  template <class F> AnyFuture AnyFuture::then(F &&f, ThreadPool &pool) const {
+    if (!state) {
+      throw UndefinedAnyException();
+    }
+    auto continuation = [previous = state, f = std::forward<F>(f)]() { return f(previous->get()); };
+    auto task = std::make_shared<async_detail::AsyncTask<decltype(continuation)>>(
+        std::move(continuation));
+    state->addContinuation(task, pool);
+    return AnyFuture(std::move(task));
+  }
+
+}  // namespace revisited
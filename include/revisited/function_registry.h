@@ -0,0 +1,226 @@
+#pragma once
+
+#include <revisited/any_function.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace revisited {
+
+  /**
+   * Is raised when adding a function to a frozen registry
+   */
+  struct FrozenFunctionRegistryException : public std::exception {
+    const char *what() const noexcept override {
+      return "cannot add functions to a frozen FunctionRegistry";
+    }
+  };
+
+  /**
+   * Is raised when adding a function with a name that is already registered
+   */
+  struct DuplicateFunctionException : public std::exception {
+    const char *what() const noexcept override { return "function name already registered"; }
+  };
+
+  /**
+   * Is raised when looking up a name that is not registered
+   */
+  struct UnknownFunctionException : public std::exception {
+    const char *what() const noexcept override { return "no function registered with name"; }
+  };
+
+  namespace function_registry_detail {
+    constexpr uint64_t hashName(std::string_view name, uint64_t seed) {
+      uint64_t hash = 14695981039346656037ull ^ (seed * 0x9e3779b97f4a7c15ull);
+      for (auto c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+      }
+      return hash ^ (hash >> 29);
+    }
+  }  // namespace function_registry_detail
+
+  /**
+   * A collection of named `AnyFunction`s for script bindings.
+   * After all functions are added, `freeze` builds a minimal perfect hash over the names, so that
+   * each lookup requires at most two hashes and a single string comparison. Handles returned by
+   * `add` and `find` remain valid for the lifetime of the registry.
+   */
+  class FunctionRegistry {
+  public:
+    using Handle = size_t;
+
+    /**
+     * A registered function with its signature.
+     */
+    struct Entry {
+      std::string name;
+      AnyFunction function;
+      TypeID returnType;
+      std::vector<TypeID> argumentTypes;
+      bool isVariadic;
+    };
+
+  private:
+    std::vector<Entry> entries;
+    std::unordered_map<std::string, Handle> names;
+    std::vector<int64_t> displacements;
+    std::vector<Handle> slots;
+    bool frozen = false;
+
+    size_t slotFor(std::string_view name) const {
+      using function_registry_detail::hashName;
+      auto displacement = displacements[hashName(name, 0) % displacements.size()];
+      if (displacement < 0) {
+        return static_cast<size_t>(-displacement - 1);
+      }
+      return hashName(name, static_cast<uint64_t>(displacement)) % slots.size();
+    }
+
+  public:
+    FunctionRegistry() = default;
+    FunctionRegistry(const FunctionRegistry &) = delete;
+    FunctionRegistry &operator=(const FunctionRegistry &) = delete;
+
+    /**
+     * Registers a function under the given name.
+     * Raises a `FrozenFunctionRegistryException` if the registry is frozen and a
+     * `DuplicateFunctionException` if the name is already in use.
+     */
+    Handle add(std::string name, const AnyFunction &function) {
+      if (frozen) {
+        throw FrozenFunctionRegistryException();
+      }
+      if (names.find(name) != names.end()) {
+        throw DuplicateFunctionException();
+      }
+      Entry entry{std::move(name), function, function.returnType(), {}, function.isVariadic()};
+      for (size_t i = 0; i < function.argumentCount(); ++i) {
+        entry.argumentTypes.push_back(function.argumentType(i));
+      }
+      names.emplace(entry.name, entries.size());
+      entries.push_back(std::move(entry));
+      return entries.size() - 1;
+    }
+
+    /**
+     * Builds the perfect hash. No functions can be added afterwards.
+     */
+    void freeze() {
+      using function_registry_detail::hashName;
+      if (frozen) {
+        return;
+      }
+      frozen = true;
+      names.clear();
+      auto count = entries.size();
+      if (count == 0) {
+        return;
+      }
+
+      std::vector<std::vector<Handle>> buckets(count);
+      for (Handle i = 0; i < count; ++i) {
+        buckets[hashName(entries[i].name, 0) % count].push_back(i);
+      }
+      std::vector<size_t> order(count);
+      for (size_t i = 0; i < count; ++i) {
+        order[i] = i;
+      }
+      std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return buckets[a].size() > buckets[b].size();
+      });
+
+      displacements.assign(count, 0);
+      slots.assign(count, count);
+      std::vector<size_t> bucketSlots;
+      size_t nextFree = 0;
+      for (auto bucketIndex : order) {
+        auto &bucket = buckets[bucketIndex];
+        if (bucket.empty()) {
+          break;
+        }
+        if (bucket.size() == 1) {
+          while (slots[nextFree] != count) {
+            nextFree++;
+          }
+          slots[nextFree] = bucket[0];
+          displacements[bucketIndex] = -static_cast<int64_t>(nextFree) - 1;
+          continue;
+        }
+        for (uint64_t displacement = 1;; ++displacement) {
+          bucketSlots.clear();
+          for (auto handle : bucket) {
+            auto slot = hashName(entries[handle].name, displacement) % count;
+            if (slots[slot] != count
+                || std::find(bucketSlots.begin(), bucketSlots.end(), slot) != bucketSlots.end()) {
+              break;
+            }
+            bucketSlots.push_back(slot);
+          }
+          if (bucketSlots.size() == bucket.size()) {
+            for (size_t i = 0; i < bucket.size(); ++i) {
+              slots[bucketSlots[i]] = bucket[i];
+            }
+            displacements[bucketIndex] = static_cast<int64_t>(displacement);
+            break;
+          }
+        }
+      }
+    }
+
+    bool isFrozen() const { return frozen; }
+
+    size_t size() const { return entries.size(); }
+
+    /**
+     * Returns the handle of the function with the given name or `std::nullopt` if it is not
+     * registered.
+     */
+    std::optional<Handle> find(std::string_view name) const {
+      if (!frozen) {
+        auto it = names.find(std::string(name));
+        if (it == names.end()) {
+          return std::nullopt;
+        }
+        return it->second;
+      }
+      if (slots.empty()) {
+        return std::nullopt;
+      }
+      auto handle = slots[slotFor(name)];
+      if (entries[handle].name != name) {
+        return std::nullopt;
+      }
+      return handle;
+    }
+
+    /**
+     * Returns the handle of the function with the given name.
+     * Raises an `UnknownFunctionException` if it is not registered.
+     */
+    Handle get(std::string_view name) const {
+      if (auto handle = find(name)) {
+        return *handle;
+      }
+      throw UnknownFunctionException();
+    }
+
+    const Entry &operator[](Handle handle) const { return entries[handle]; }
+
+    Any call(Handle handle, const AnyArguments &args) const {
+      return entries[handle].function.call(args);
+    }
+
+    Any call(std::string_view name, const AnyArguments &args) const {
+      return call(get(name), args);
+    }
+  };
+
+}  // namespace revisited
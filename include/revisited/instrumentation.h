@@ -0,0 +1,87 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace revisited {
+
+  namespace instrumentation_detail {
+
+    struct PairHash {
+      template <class A, class B> size_t operator()(const std::pair<A, B> &p) const {
+        return std::hash<A>()(p.first) ^ (std::hash<B>()(p.second) * 31);
+      }
+    };
+
+    /**
+     * Collects `Data` records separately for every thread, so that recording only locks an
+     * uncontended mutex. The per-thread records are merged when a snapshot is requested and
+     * outlive the threads that created them.
+     */
+    template <class Data> class ThreadLocalRecorder {
+    private:
+      struct Local {
+        std::mutex mutex;
+        Data data;
+      };
+
+      std::mutex mutex;
+      std::vector<std::shared_ptr<Local>> locals;
+
+      static ThreadLocalRecorder &instance() {
+        static ThreadLocalRecorder recorder;
+        return recorder;
+      }
+
+      static Local &local() {
+        thread_local std::shared_ptr<Local> local = []() {
+          auto &recorder = instance();
+          auto result = std::make_shared<Local>();
+          std::lock_guard<std::mutex> lock(recorder.mutex);
+          recorder.locals.push_back(result);
+          return result;
+        }();
+        return *local;
+      }
+
+    public:
+      /**
+       * Calls `f(Data &)` with the current thread's record.
+       */
+      template <class F> static void record(F &&f) {
+        auto &current = local();
+        std::lock_guard<std::mutex> lock(current.mutex);
+        f(current.data);
+      }
+
+      /**
+       * Calls `f(const Data &)` for the record of every thread that has recorded data.
+       */
+      template <class F> static void forEach(F &&f) {
+        auto &recorder = instance();
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        for (auto &current : recorder.locals) {
+          std::lock_guard<std::mutex> localLock(current->mutex);
+          f(std::as_const(current->data));
+        }
+      }
+
+      /**
+       * Resets the records of all threads.
+       */
+      static void reset() {
+        auto &recorder = instance();
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        for (auto &current : recorder.locals) {
+          std::lock_guard<std::mutex> localLock(current->mutex);
+          current->data = Data();
+        }
+      }
+    };
+
+  }  // namespace instrumentation_detail
+
+}  // namespace revisited
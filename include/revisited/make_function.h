@@ -32,6 +32,27 @@ namespace revisited {
   template <typename R, typename... A> struct get_signature_impl<R (*)(A...)> {
     using type = R(A...);
   };
+
+  // member pointers take the object as their first argument
+  template <typename C, typename R, typename... A> struct get_signature_impl<R (C::*)(A...)> {
+    using type = R(C &, A...);
+  };
+  template <typename C, typename R, typename... A>
+  struct get_signature_impl<R (C::*)(A...) const> {
+    using type = R(const C &, A...);
+  };
+  template <typename C, typename R, typename... A>
+  struct get_signature_impl<R (C::*)(A...) noexcept> {
+    using type = R(C &, A...);
+  };
+  template <typename C, typename R, typename... A>
+  struct get_signature_impl<R (C::*)(A...) const noexcept> {
+    using type = R(const C &, A...);
+  };
+  template <typename C, typename R> struct get_signature_impl<R C::*> {
+    using type = R(const C &);
+  };
+
   template <typename T> using get_signature = typename get_signature_impl<T>::type;
 
   template <typename F> using make_function_type = std::function<get_signature<F>>;
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <revisited/any_function.h>
+#include <revisited/any_hash.h>
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace revisited {
+
+  /**
+   * Defines the size and eviction strategy of a memoization cache.
+   * The cache is split into `shards` independently locked parts, which share the `capacity`
+   * evenly. The number of shards is limited to the capacity, so that the cache never holds more
+   * than `capacity` results.
+   */
+  struct MemoizePolicy {
+    enum class Eviction { LeastRecentlyUsed, LeastFrequentlyUsed };
+
+    size_t capacity = 1024;
+    Eviction eviction = Eviction::LeastRecentlyUsed;
+    size_t shards = 8;
+  };
+
+  /**
+   * Usage statistics of a memoization cache.
+   * Calls with arguments that cannot be hashed are counted as misses.
+   */
+  struct MemoizeStatistics {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    /**
+     * The number of currently cached results
+     */
+    size_t entries = 0;
+
+    double hitRate() const {
+      auto calls = hits + misses;
+      return calls == 0 ? 0 : double(hits) / double(calls);
+    }
+  };
+
+  namespace memoize_detail {
+
+    struct Key {
+      size_t hash;
+      std::vector<Any> values;
+
+      bool matches(size_t otherHash, const AnyArguments &args) const {
+        if (hash != otherHash || values.size() != args.size()) {
+          return false;
+        }
+        for (size_t i = 0; i < values.size(); ++i) {
+          if (!equalValues(values[i], args[i])) {
+            return false;
+          }
+        }
+        return true;
+      }
+    };
+
+    /**
+     * A single cache shard. Entries are grouped into buckets by use count, which is only
+     * incremented for LFU eviction. Within a bucket, the least recently used entry is at the front.
+     */
+    class Shard {
+    private:
+      struct Entry {
+        Key key;
+        Any result;
+        size_t frequency;
+      };
+
+      using Entries = std::list<Entry>;
+
+      std::mutex mutex;
+      std::map<size_t, Entries> buckets;
+      std::unordered_multimap<size_t, typename Entries::iterator> index;
+      MemoizePolicy::Eviction eviction;
+      size_t capacity;
+      size_t size = 0;
+      MemoizeStatistics statistics;
+
+      typename Entries::iterator *find(size_t hash, const AnyArguments &args) {
+        auto range = index.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+          if (it->second->key.matches(hash, args)) {
+            return &it->second;
+          }
+        }
+        return nullptr;
+      }
+
+      void use(typename Entries::iterator entry) {
+        auto bucket = buckets.find(entry->frequency);
+        if (eviction == MemoizePolicy::Eviction::LeastFrequentlyUsed) {
+          entry->frequency++;
+        }
+        auto &target = buckets[entry->frequency];
+        target.splice(target.end(), bucket->second, entry);
+        if (bucket->second.empty()) {
+          buckets.erase(bucket);
+        }
+      }
+
+      void evict() {
+        auto bucket = buckets.begin();
+        auto entry = bucket->second.begin();
+        auto range = index.equal_range(entry->key.hash);
+        for (auto it = range.first; it != range.second; ++it) {
+          if (it->second == entry) {
+            index.erase(it);
+            break;
+          }
+        }
+        bucket->second.erase(entry);
+        if (bucket->second.empty()) {
+          buckets.erase(bucket);
+        }
+        size--;
+        statistics.evictions++;
+      }
+
+    public:
+      Shard(MemoizePolicy::Eviction _eviction, size_t _capacity)
+          : eviction(_eviction), capacity(std::max<size_t>(_capacity, 1)) {}
+
+      bool lookup(size_t hash, const AnyArguments &args, Any &result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto entry = find(hash, args);
+        if (!entry) {
+          statistics.misses++;
+          return false;
+        }
+        statistics.hits++;
+        use(*entry);
+        result = (*entry)->result;
+        return true;
+      }
+
+      /**
+       * Inserts the result unless another thread has inserted a result for the same arguments
+       * since the lookup.
+       */
+      void insert(Key &&key, const AnyArguments &args, const Any &result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (find(key.hash, args)) {
+          return;
+        }
+        if (size >= capacity) {
+          evict();
+        }
+        auto hash = key.hash;
+        auto &bucket = buckets[0];
+        bucket.push_back(Entry{std::move(key), result, 0});
+        index.emplace(hash, std::prev(bucket.end()));
+        size++;
+      }
+
+      void missed() {
+        std::lock_guard<std::mutex> lock(mutex);
+        statistics.misses++;
+      }
+
+      void addStatistics(MemoizeStatistics &total) {
+        std::lock_guard<std::mutex> lock(mutex);
+        total.hits += statistics.hits;
+        total.misses += statistics.misses;
+        total.evictions += statistics.evictions;
+        total.entries += size;
+      }
+
+      void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        buckets.clear();
+        index.clear();
+        size = 0;
+        statistics = MemoizeStatistics();
+      }
+    };
+
+    class MemoizedSpecificAnyFunction : public SpecificAnyFunctionBase {
+    private:
+      std::shared_ptr<const SpecificAnyFunctionBase> function;
+      std::vector<std::unique_ptr<Shard>> shards;
+
+    public:
+      MemoizedSpecificAnyFunction(std::shared_ptr<const SpecificAnyFunctionBase> _function,
+                                  const MemoizePolicy &policy)
+          : function(std::move(_function)) {
+        auto capacity = std::max<size_t>(policy.capacity, 1);
+        auto shardCount = std::clamp<size_t>(policy.shards, 1, capacity);
+        for (size_t i = 0; i < shardCount; ++i) {
+          auto shardCapacity = capacity / shardCount + (i < capacity % shardCount ? 1 : 0);
+          shards.emplace_back(std::make_unique<Shard>(policy.eviction, shardCapacity));
+        }
+      }
+
+      Any call(const AnyArguments &args) const override {
+        size_t hash = args.size();
+        for (auto &arg : args) {
+          auto valueHash = tryHashValue(arg);
+          if (!valueHash) {
+            shards[0]->missed();
+            return function->call(args);
+          }
+          hash ^= *valueHash + std::hash<TypeID>()(arg.type()) + 0x9e3779b9 + (hash << 6)
+                  + (hash >> 2);
+        }
+        auto &shard = *shards[hash % shards.size()];
+        Any result;
+        if (shard.lookup(hash, args, result)) {
+          return result;
+        }
+        result = function->call(args);
+        Key key{hash, std::vector<Any>(args.size())};
+        for (size_t i = 0; i < args.size(); ++i) {
+          any_hash_detail::copyValue(args[i], key.values[i]);
+        }
+        shard.insert(std::move(key), args, result);
+        return result;
+      }
+
+      void callInto(const AnyArguments &args, const AnyResultColumn &result) const override {
+        any_function_detail::storeBatchResults<Any>(1, result,
+                                                    [&](size_t) { return call(args); });
+      }
+
+      void callBatch(const std::vector<AnyColumn> &columns,
+                     const AnyResultColumn &results) const override {
+        function->callBatch(columns, results);
+      }
+
+      TypeID returnType() const override { return function->returnType(); }
+
+      TypeID argumentType(size_t i) const override { return function->argumentType(i); }
+
+      ArgumentConversion argumentConversion(size_t i, const Any &arg) const override {
+        return function->argumentConversion(i, arg);
+      }
+
+      size_t argumentCount() const override { return function->argumentCount(); }
+
+      bool isVariadic() const override { return function->isVariadic(); }
+
+      MemoizeStatistics statistics() const {
+        MemoizeStatistics total;
+        for (auto &shard : shards) {
+          shard->addStatistics(total);
+        }
+        return total;
+      }
+
+      void clear() const {
+        for (auto &shard : shards) {
+          shard->clear();
+        }
+      }
+    };
+
+  }  // namespace memoize_detail
+
+  /**
+   * An `AnyFunction` that caches its results, as returned by `memoize`.
+   */
+  class MemoizedAnyFunction : public AnyFunction {
+  private:
+    std::shared_ptr<const memoize_detail::MemoizedSpecificAnyFunction> memoized;
+
+  public:
+    MemoizedAnyFunction(std::shared_ptr<const memoize_detail::MemoizedSpecificAnyFunction> f)
+        : AnyFunction(std::shared_ptr<const SpecificAnyFunctionBase>(f)),
+          memoized(std::move(f)) {}
+
+    /**
+     * Returns the combined statistics of all shards.
+     */
+    MemoizeStatistics statistics() const { return memoized->statistics(); }
+
+    /**
+     * Removes all cached results and resets the statistics.
+     */
+    void clear() const { memoized->clear(); }
+  };
+
+  /**
+   * Returns a function caching the results of `f`, keyed on the values and types of the
+   * arguments. Only pure functions should be memoized, as cached results are returned without
+   * calling `f` and are shared between calls. Arguments whose types are not hashable
+   * (see `REVISITED_HASHABLE_TYPES`) bypass the cache. Batch calls are not cached.
+   */
+  inline MemoizedAnyFunction memoize(const AnyFunction &f, const MemoizePolicy &policy = {}) {
+    if (!f) {
+      throw UndefinedAnyFunctionException();
+    }
+    return std::make_shared<const memoize_detail::MemoizedSpecificAnyFunction>(f.specificFunction(),
+                                                                               policy);
+  }
+
+}  // namespace revisited
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <revisited/async.h>
+#include <revisited/visitor.h>
+
+#include <algorithm>
+#include <deque>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+namespace revisited {
+
+  /**
+   * Enumerates the children of a node of type `Node` for the traversals below by calling `f` with
+   * a reference to each child. The default implementation iterates over `node.children()`, which
+   * should return a range of pointers or smart pointers to nodes. Null pointers are skipped.
+   * Specialize this class for nodes that store their children differently. The traversals
+   * determine the node type from the static type of the root, so children must be convertible to
+   * references of that type.
+   */
+  template <class Node> struct TraversalChildren {
+    template <class N, class F> static void forEach(N &node, F &&f) {
+      for (auto &&child : node.children()) {
+        if (child) {
+          f(*child);
+        }
+      }
+    }
+  };
+
+  struct TraversalOptions {
+    /**
+     * Visit each node only once, even if it is reachable through multiple paths, as in directed
+     * acyclic graphs. Also required for traversing graphs that contain cycles. Visited nodes are
+     * tracked by address.
+     */
+    bool visitOnce = false;
+  };
+
+  namespace traversal_detail {
+
+    inline void prefetch([[maybe_unused]] const void *address) {
+#if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch(address);
+#endif
+    }
+
+    /**
+     * Accepts the visitor. The results of `RecursiveVisitor`s are ignored.
+     */
+    template <class Node, class Visitor> void accept(Node &node, Visitor &visitor) {
+      if constexpr (std::is_base_of<RecursiveVisitorBase, Visitor>::value) {
+        node.accept(static_cast<RecursiveVisitorBase &>(visitor));
+      } else {
+        node.accept(static_cast<VisitorBase &>(visitor));
+      }
+    }
+
+    /**
+     * The default pruning predicate, which never skips any children.
+     */
+    struct NoPruning {
+      template <class Node> bool operator()(Node &) const { return false; }
+    };
+
+    /**
+     * Calls `f` with a pointer to each child of `node`.
+     */
+    template <class Node, class F> void forEachChild(Node &node, F &&f) {
+      TraversalChildren<typename std::remove_const<Node>::type>::forEach(
+          node, [&](Node &child) { f(&child); });
+    }
+
+    class VisitedNodes {
+    private:
+      bool enabled;
+      std::unordered_set<const void *> nodes;
+
+    public:
+      explicit VisitedNodes(const TraversalOptions &options) : enabled(options.visitOnce) {}
+
+      VisitedNodes(const TraversalOptions &options, const void *visited)
+          : VisitedNodes(options) {
+        insert(visited);
+      }
+
+      /**
+       * @return - `true`, if the node has not been visited before and should be visited now
+       */
+      bool insert(const void *node) { return !enabled || nodes.insert(node).second; }
+    };
+
+    template <class Node, class Visitor, class Prune>
+    void preOrderTraversal(Node &root, Visitor &visitor, VisitedNodes &visited, Prune &prune) {
+      std::vector<Node *> stack{&root};
+      while (!stack.empty()) {
+        auto *node = stack.back();
+        stack.pop_back();
+        if (visited.insert(node)) {
+          accept(*node, visitor);
+          if (!prune(*node)) {
+            auto first = stack.size();
+            forEachChild(*node, [&](Node *child) { stack.push_back(child); });
+            std::reverse(stack.begin() + first, stack.end());
+          }
+        }
+        if (!stack.empty()) {
+          prefetch(stack.back());
+        }
+      }
+    }
+
+  }  // namespace traversal_detail
+
+  /**
+   * Visits `root` and its descendants depth-first, visiting each node before its children.
+   * Nodes are kept on an explicit stack, so deep trees do not overflow the call stack. After
+   * visiting a node, the node visited next is prefetched, which is its first child or, for leaves,
+   * the next node on the stack. After visiting a node, `prune(node)` is called and the node's
+   * children are skipped if it returns `true`.
+   */
+  template <class Node, class Visitor, class Prune = traversal_detail::NoPruning>
+  void preOrderTraversal(Node &root, Visitor &visitor, const TraversalOptions &options = {},
+                         Prune &&prune = Prune()) {
+    traversal_detail::VisitedNodes visited(options);
+    traversal_detail::preOrderTraversal(root, visitor, visited, prune);
+  }
+
+  /**
+   * Visits `root` and its descendants depth-first, visiting each node after its children.
+   */
+  template <class Node, class Visitor>
+  void postOrderTraversal(Node &root, Visitor &visitor, const TraversalOptions &options = {}) {
+    struct Entry {
+      Node *node;
+      bool expanded;
+    };
+
+    traversal_detail::VisitedNodes visited(options);
+    std::vector<Entry> stack{Entry{&root, false}};
+    auto pop = [&]() {
+      stack.pop_back();
+      if (!stack.empty()) {
+        traversal_detail::prefetch(stack.back().node);
+      }
+    };
+    while (!stack.empty()) {
+      auto entry = stack.back();
+      if (entry.expanded) {
+        pop();
+        traversal_detail::accept(*entry.node, visitor);
+        continue;
+      }
+      if (!visited.insert(entry.node)) {
+        pop();
+        continue;
+      }
+      stack.back().expanded = true;
+      auto first = stack.size();
+      traversal_detail::forEachChild(*entry.node,
+                                     [&](Node *child) { stack.push_back(Entry{child, false}); });
+      std::reverse(stack.begin() + first, stack.end());
+      traversal_detail::prefetch(stack.back().node);
+    }
+  }
+
+  /**
+   * Visits `root` and its descendants level by level. Pruning works as in `preOrderTraversal`.
+   */
+  template <class Node, class Visitor, class Prune = traversal_detail::NoPruning>
+  void breadthFirstTraversal(Node &root, Visitor &visitor, const TraversalOptions &options = {},
+                             Prune &&prune = Prune()) {
+    traversal_detail::VisitedNodes visited(options);
+    std::deque<Node *> queue{&root};
+    while (!queue.empty()) {
+      auto *node = queue.front();
+      queue.pop_front();
+      if (!queue.empty()) {
+        traversal_detail::prefetch(queue.front());
+      }
+      if (!visited.insert(node)) {
+        continue;
+      }
+      traversal_detail::accept(*node, visitor);
+      if (prune(*node)) {
+        continue;
+      }
+      traversal_detail::forEachChild(*node, [&](Node *child) { queue.push_back(child); });
+    }
+  }
+
+  /**
+   * Visits `root` with a visitor created by `makeVisitor()` and then traverses the subtree of each
+   * of its children in pre-order as a separate task on `pool`, using a new visitor for every
+   * subtree. Pruning works as in `preOrderTraversal`, but `prune` is called concurrently by the
+   * tasks. With `visitOnce`, every task tracks the nodes it has visited separately, starting with
+   * the root, so cycles back to the root are not followed. Nodes reachable from several subtrees
+   * are still visited once per subtree.
+   * @return - the visitors in order, starting with the root's visitor, for combining their results
+   */
+  template <class Node, class MakeVisitor, class Prune = traversal_detail::NoPruning>
+  auto parallelPreOrderTraversal(Node &root, MakeVisitor &&makeVisitor,
+                                 ThreadPool &pool = ThreadPool::global(),
+                                 const TraversalOptions &options = {}, Prune &&prune = Prune()) {
+    using Visitor = decltype(makeVisitor());
+    Visitor rootVisitor = makeVisitor();
+    std::vector<Node *> subtrees;
+    traversal_detail::accept(root, rootVisitor);
+    if (!prune(root)) {
+      traversal_detail::forEachChild(root, [&](Node *child) { subtrees.push_back(child); });
+    }
+
+    std::vector<Visitor> visitors;
+    visitors.reserve(subtrees.size() + 1);
+    visitors.push_back(std::move(rootVisitor));
+    for (size_t i = 0; i < subtrees.size(); ++i) {
+      visitors.push_back(makeVisitor());
+    }
+
+    std::vector<AnyFuture> futures;
+    futures.reserve(subtrees.size());
+    for (size_t i = 0; i < subtrees.size(); ++i) {
+      futures.push_back(pool.async([&, i]() {
+        traversal_detail::VisitedNodes visited(options, &root);
+        traversal_detail::preOrderTraversal(*subtrees[i], visitors[i + 1], visited, prune);
+      }));
+    }
+    // all tasks must finish before rethrowing, as they reference the visitors
+    for (auto &future : futures) {
+      future.wait();
+    }
+    for (auto &future : futures) {
+      future.get();
+    }
+    return visitors;
+  }
+
+}  // namespace revisited
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <revisited/any.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace revisited {
+
+  /**
+   * An `Any` that can be read and replaced concurrently from multiple threads. The value is
+   * guarded by a mutex, which `load`, `store`, `exchange` and `update` lock, and a version that is
+   * incremented on every modification.
+   * Readers that repeatedly access the value should use a `Snapshot`, which caches the value
+   * together with its version. While the version is unchanged, a snapshot read is a single atomic
+   * load that takes no lock and does not modify reference counts. After a modification the
+   * snapshot copies the new value under the mutex, so reads are not wait-free and may block while
+   * a writer holds the lock. Stored values are shared between readers and should not be modified.
+   */
+  class VersionedAny {
+  private:
+    alignas(64) std::atomic<uint64_t> currentVersion{0};
+    alignas(64) mutable std::mutex mutex;
+    Any value;
+
+  public:
+    /**
+     * A reader's cached copy of an `VersionedAny`'s value.
+     * The copy remains valid and unchanged until the next call to `refresh` or `get`, even if the
+     * `VersionedAny` is updated in the meantime. Snapshots should not be shared between threads.
+     */
+    class Snapshot {
+    private:
+      const VersionedAny *source;
+      uint64_t cachedVersion;
+      Any cached;
+
+    public:
+      explicit Snapshot(const VersionedAny &_source) : source(&_source) {
+        cachedVersion = source->load(cached);
+      }
+
+      /**
+       * Updates the cached value if the source has been modified, which locks the source's mutex.
+       * @return - `true`, if the value has been updated
+       */
+      bool refresh() {
+        if (source->currentVersion.load(std::memory_order_acquire) == cachedVersion) {
+          return false;
+        }
+        cachedVersion = source->load(cached);
+        return true;
+      }
+
+      /**
+       * Refreshes and returns the cached value.
+       */
+      const Any &get() {
+        refresh();
+        return cached;
+      }
+
+      /**
+       * The cached value without checking for updates.
+       */
+      const Any &value() const { return cached; }
+
+      /**
+       * The version of the cached value.
+       */
+      uint64_t version() const { return cachedVersion; }
+    };
+
+    VersionedAny() = default;
+    explicit VersionedAny(Any initial) : value(std::move(initial)) {}
+    VersionedAny(const VersionedAny &) = delete;
+    VersionedAny &operator=(const VersionedAny &) = delete;
+
+    /**
+     * Returns a copy of the current value, locking the mutex.
+     */
+    Any load() const {
+      std::lock_guard<std::mutex> lock(mutex);
+      return value;
+    }
+
+    /**
+     * Copies the current value to `result` and returns its version.
+     */
+    uint64_t load(Any &result) const {
+      std::lock_guard<std::mutex> lock(mutex);
+      result = value;
+      return currentVersion.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Replaces the value. The previous value is released after the lock is released and remains
+     * alive while referenced by snapshots.
+     */
+    void store(Any newValue) { exchange(std::move(newValue)); }
+
+    /**
+     * Replaces the value and returns the previous one.
+     */
+    Any exchange(Any newValue) {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::swap(value, newValue);
+      currentVersion.fetch_add(1, std::memory_order_release);
+      return newValue;
+    }
+
+    /**
+     * Atomically replaces the value by `f(value)`, where `f` receives the current value as a
+     * `const Any &`. `f` must not access the `VersionedAny`.
+     */
+    template <class F> void update(F &&f) {
+      Any previous;
+      std::lock_guard<std::mutex> lock(mutex);
+      Any newValue = f(std::as_const(value));
+      previous = std::exchange(value, std::move(newValue));
+      currentVersion.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * Incremented on every modification.
+     */
+    uint64_t version() const { return currentVersion.load(std::memory_order_acquire); }
+
+    /**
+     * Creates a snapshot of the current value.
+     */
+    Snapshot snapshot() const { return Snapshot(*this); }
+  };
+
+}  // namespace revisited
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <revisited/visitor.h>
+
+#include <cstdint>
+#include <exception>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace revisited {
+
+  /**
+   * Raised when accessing an object through a handle whose object has been erased.
+   */
+  struct InvalidVisitableHandleException : public std::exception {
+    const char *what() const noexcept override { return "accessed erased visitable by handle"; }
+  };
+
+  /**
+   * A handle to an object of type `T` in a `VisitablePool` or `VisitableCollection`. Handles stay
+   * valid when other objects are added or erased. Once their object is erased, the handle is
+   * invalid, even if its slot is reused by a new object.
+   */
+  template <class T> struct VisitableHandle {
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+
+    bool operator==(const VisitableHandle &other) const {
+      return slot == other.slot && generation == other.generation;
+    }
+    bool operator!=(const VisitableHandle &other) const { return !(*this == other); }
+  };
+
+  namespace visitable_collection_detail {
+
+    /**
+     * Finds the first type in the inheritance list of `V` that the visitor accepts and visits all
+     * `objects` with its visit method, so the visitor is only resolved once.
+     */
+    template <class V, class Objects, class T, typename... Rest>
+    void visitAll(Objects &objects, TypeList<T, Rest...>, VisitorBase &visitor) {
+      if (auto *v = visitor.asVisitorFor<T>()) {
+        for (auto &object : objects) {
+          v->visit(visitor_detail::castVisitable<V, T>(&object));
+        }
+      } else if constexpr (sizeof...(Rest) > 0) {
+        visitAll<V>(objects, TypeList<Rest...>(), visitor);
+      } else {
+        throw InvalidVisitorException(getTypeID<V>(), visitor.visitorType());
+      }
+    }
+
+    template <class V, class Objects>
+    void visitAll(Objects &, TypeList<>, VisitorBase &visitor) {
+      throw InvalidVisitorException(getTypeID<V>(), visitor.visitorType());
+    }
+
+  }  // namespace visitable_collection_detail
+
+  /**
+   * Stores visitable objects of type `T` contiguously. Objects are accessed through stable
+   * handles. Erasing an object moves the last object into its place, so references and iteration
+   * order only remain valid until objects are added or erased.
+   */
+  template <class T> class VisitablePool {
+  private:
+    struct Slot {
+      uint32_t index;
+      uint32_t generation;
+    };
+
+    std::vector<T> objects;
+    std::vector<uint32_t> objectSlots;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+
+  public:
+    using Handle = VisitableHandle<T>;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    /**
+     * Constructs a new object from `args` and returns its handle.
+     */
+    template <typename... Args> Handle emplace(Args &&... args) {
+      objects.emplace_back(std::forward<Args>(args)...);
+      uint32_t slot;
+      if (freeSlots.empty()) {
+        slot = uint32_t(slots.size());
+        slots.push_back(Slot{0, 0});
+      } else {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+      }
+      slots[slot].index = uint32_t(objects.size() - 1);
+      objectSlots.push_back(slot);
+      return Handle{slot, slots[slot].generation};
+    }
+
+    bool contains(Handle handle) const {
+      return handle.slot < slots.size() && slots[handle.slot].generation == handle.generation;
+    }
+
+    /**
+     * @return - a pointer to the object of `handle` or `nullptr`, if it has been erased
+     */
+    T *tryGet(Handle handle) {
+      return contains(handle) ? &objects[slots[handle.slot].index] : nullptr;
+    }
+
+    const T *tryGet(Handle handle) const {
+      return contains(handle) ? &objects[slots[handle.slot].index] : nullptr;
+    }
+
+    T &get(Handle handle) {
+      if (auto *object = tryGet(handle)) {
+        return *object;
+      }
+      throw InvalidVisitableHandleException();
+    }
+
+    const T &get(Handle handle) const {
+      if (auto *object = tryGet(handle)) {
+        return *object;
+      }
+      throw InvalidVisitableHandleException();
+    }
+
+    /**
+     * Erases the object of `handle`. Throws an `InvalidVisitableHandleException` if it has already
+     * been erased.
+     */
+    void erase(Handle handle) {
+      if (!contains(handle)) {
+        throw InvalidVisitableHandleException();
+      }
+      auto index = slots[handle.slot].index;
+      if (index + 1 != objects.size()) {
+        objects[index] = std::move(objects.back());
+        objectSlots[index] = objectSlots.back();
+        slots[objectSlots[index]].index = index;
+      }
+      objects.pop_back();
+      objectSlots.pop_back();
+      ++slots[handle.slot].generation;
+      freeSlots.push_back(handle.slot);
+    }
+
+    void clear() {
+      for (auto slot : objectSlots) {
+        ++slots[slot].generation;
+        freeSlots.push_back(slot);
+      }
+      objects.clear();
+      objectSlots.clear();
+    }
+
+    void reserve(size_t count) {
+      objects.reserve(count);
+      objectSlots.reserve(count);
+      slots.reserve(count);
+    }
+
+    size_t size() const { return objects.size(); }
+    bool empty() const { return objects.empty(); }
+
+    iterator begin() { return objects.begin(); }
+    iterator end() { return objects.end(); }
+    const_iterator begin() const { return objects.begin(); }
+    const_iterator end() const { return objects.end(); }
+
+    /**
+     * Visits all objects, as if accepting the visitor with each of them. The visit method is only
+     * resolved once instead of for every object, which also means that dispatches are not
+     * recorded by visitor profiling. Throws an `InvalidVisitorException` if the pool is not empty
+     * and the visitor does not accept `T`.
+     */
+    void acceptAll(VisitorBase &visitor) {
+      if (!objects.empty()) {
+        visitable_collection_detail::visitAll<T>(objects, typename T::Types(), visitor);
+      }
+    }
+
+    void acceptAll(VisitorBase &visitor) const {
+      if (!objects.empty()) {
+        visitable_collection_detail::visitAll<const T>(objects, typename T::ConstTypes(), visitor);
+      }
+    }
+  };
+
+  /**
+   * A heterogeneous container of visitables that stores each of the types `Types` in a separate
+   * `VisitablePool`. Compared to a vector of pointers to a common base class, objects of the same
+   * type are stored next to each other and are not allocated individually.
+   */
+  template <typename... Types> class VisitableCollection {
+  private:
+    std::tuple<VisitablePool<Types>...> pools;
+
+    template <class T> constexpr static void assertContains() {
+      static_assert((std::is_same<T, Types>::value || ...),
+                    "type is not stored in this VisitableCollection");
+    }
+
+  public:
+    template <class T> using Handle = VisitableHandle<T>;
+
+    template <class T> VisitablePool<T> &pool() {
+      assertContains<T>();
+      return std::get<VisitablePool<T>>(pools);
+    }
+
+    template <class T> const VisitablePool<T> &pool() const {
+      assertContains<T>();
+      return std::get<VisitablePool<T>>(pools);
+    }
+
+    template <class T, typename... Args> Handle<T> emplace(Args &&... args) {
+      return pool<T>().emplace(std::forward<Args>(args)...);
+    }
+
+    template <class T> Handle<typename std::decay<T>::type> insert(T &&value) {
+      return emplace<typename std::decay<T>::type>(std::forward<T>(value));
+    }
+
+    template <class T> bool contains(Handle<T> handle) const { return pool<T>().contains(handle); }
+    template <class T> T *tryGet(Handle<T> handle) { return pool<T>().tryGet(handle); }
+    template <class T> const T *tryGet(Handle<T> handle) const { return pool<T>().tryGet(handle); }
+    template <class T> T &get(Handle<T> handle) { return pool<T>().get(handle); }
+    template <class T> const T &get(Handle<T> handle) const { return pool<T>().get(handle); }
+    template <class T> void erase(Handle<T> handle) { pool<T>().erase(handle); }
+
+    void clear() { (pool<Types>().clear(), ...); }
+
+    size_t size() const { return (pool<Types>().size() + ... + 0); }
+    bool empty() const { return (pool<Types>().empty() && ...); }
+
+    /**
+     * Visits all objects grouped by type in the order of `Types`, resolving the visit method once
+     * per type. See `VisitablePool::acceptAll`.
+     */
+    void acceptAll(VisitorBase &visitor) { (pool<Types>().acceptAll(visitor), ...); }
+    void acceptAll(VisitorBase &visitor) const { (pool<Types>().acceptAll(visitor), ...); }
+  };
+
+}  // namespace revisited
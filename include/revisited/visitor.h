@@ -2,6 +2,7 @@
 
 #include <revisited/inheritance_list.h>
 #include <revisited/type_index.h>
+#include <revisited/visitor_profiling_hooks.h>
 
 #include <array>
 #include <cstddef>
@@ -9,6 +10,11 @@
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <utility>
+
+#ifdef REVISITED_VISITOR_PROFILING
+#include <revisited/visitor_profiling.h>
+#endif
 
 namespace revisited {
 
@@ -27,6 +33,32 @@ namespace revisited {
     virtual ~VisitorBasePrototype() {}
   };
 
+  /**
+   * The argument types of visitors with the arguments `Types` that should be checked first when
+   * searching for a visit method, in the order provided. The remaining types are checked in their
+   * declared order afterwards. Specializations can be generated from a dispatch profile using
+   * `VisitorStatistics::writeDispatchOrder` and must be declared before the visitor is used.
+   */
+  template <class Types> struct VisitorDispatchOrder { using type = TypeList<>; };
+
+  namespace visitor_detail {
+    template <class T, typename... Types> constexpr static bool Contains
+        = (std::is_same<T, Types>::value || ...);
+
+    template <class Preferred, class Types> struct OrderedVisitorTypes;
+    template <typename... Preferred, typename... Types>
+    struct OrderedVisitorTypes<TypeList<Preferred...>, TypeList<Types...>> {
+      template <class T> struct IsPreferred {
+        constexpr static bool value = Contains<T, Types...>;
+      };
+      template <class T> struct IsRemaining {
+        constexpr static bool value = !Contains<T, Preferred...>;
+      };
+      using type = typename TypeList<Preferred...>::template Filter<IsPreferred>::template Merge<
+          typename TypeList<Types...>::template Filter<IsRemaining>>;
+    };
+  }  // namespace visitor_detail
+
   /**
    * The Visitor Prototype class. Visitors defined below are specializations of
    * this class.
@@ -36,12 +68,20 @@ namespace revisited {
                            public Single<Args>... {
   private:
     template <class First, typename... Rest>
-    inline SingleBase *getVisitorForWorker(const revisited::TypeIndex &idx) {
+    inline SingleBase *getVisitorForWorker(const revisited::TypeIndex &idx,
+                                           TypeList<First, Rest...>) {
       if (idx == getTypeIndex<First>()) {
+        if constexpr (visitor_profiling::enabled) {
+          visitor_profiling::addComparisons(sizeof...(Args) - sizeof...(Rest));
+          visitor_profiling::setMatchedArgument(getTypeID<First>());
+        }
         return static_cast<Single<First> *>(this);
       } else if constexpr (sizeof...(Rest) > 0) {
-        return getVisitorForWorker<Rest...>(idx);
+        return getVisitorForWorker(idx, TypeList<Rest...>());
       } else {
+        if constexpr (visitor_profiling::enabled) {
+          visitor_profiling::addComparisons(sizeof...(Args));
+        }
         return nullptr;
       }
     }
@@ -49,7 +89,9 @@ namespace revisited {
   public:
     SingleBase *getVisitorFor([[maybe_unused]] const revisited::TypeIndex &idx) override {
       if constexpr (sizeof...(Args) > 0) {
-        return getVisitorForWorker<Args...>(idx);
+        using DispatchOrder = typename visitor_detail::OrderedVisitorTypes<
+            typename VisitorDispatchOrder<TypeList<Args...>>::type, TypeList<Args...>>::type;
+        return getVisitorForWorker(idx, DispatchOrder());
       } else {
         return nullptr;
       }
@@ -156,52 +198,85 @@ namespace revisited {
    */
   struct IndirectVisitableBase {};
 
-  /**
-   * The regular visitor algorithm.
-   */
-  template <class V, class T, typename... Rest>
-  static void visit(V *visitable, TypeList<T, Rest...>, VisitorBase &visitor) {
-    if (auto *v = visitor.asVisitorFor<T>()) {
+  namespace visitor_detail {
+
+    template <class V, class T> inline decltype(auto) castVisitable(V *visitable) {
       if constexpr (std::is_base_of<IndirectVisitableBase, typename std::decay<V>::type>::value) {
-        v->visit(visitable->template cast<T>());
+        return visitable->template cast<T>();
       } else {
-        v->visit(static_cast<T>(*visitable));
+        return static_cast<T>(*visitable);
       }
-    } else if constexpr (sizeof...(Rest) > 0) {
-      visit(visitable, TypeList<Rest...>(), visitor);
-    } else {
-      throw InvalidVisitorException(getTypeID<V>(), visitor.visitorType());
     }
-  }
 
-  template <class V> static bool visit(V *, TypeList<>, VisitorBase &visitor) {
-    throw InvalidVisitorException(getTypeID<V>(), visitor.visitorType());
-  }
+    template <size_t Probe, class V, class Scope, class T, typename... Rest>
+    inline void visit(V *visitable, TypeList<T, Rest...>, VisitorBase &visitor, Scope &scope) {
+      if (auto *v = visitor.asVisitorFor<T>()) {
+        scope.hit(Probe + 1);
+        v->visit(castVisitable<V, T>(visitable));
+      } else if constexpr (sizeof...(Rest) > 0) {
+        visit<Probe + 1>(visitable, TypeList<Rest...>(), visitor, scope);
+      } else {
+        throw InvalidVisitorException(getTypeID<V>(), visitor.visitorType());
+      }
+    }
 
-  /**
-   * The recursive visitor algorithm.
-   */
-  template <class V, class T, typename... Rest>
-  static bool visit(V *visitable, TypeList<T, Rest...>, RecursiveVisitorBase &visitor) {
-    if (auto *v = visitor.asVisitorFor<T>()) {
-      if constexpr (std::is_base_of<IndirectVisitableBase, typename std::decay<V>::type>::value) {
-        if (v->visit(visitable->template cast<T>())) {
+    template <size_t Probe, class V, class Scope>
+    inline void visit(V *, TypeList<>, VisitorBase &visitor, Scope &) {
+      throw InvalidVisitorException(getTypeID<V>(), visitor.visitorType());
+    }
+
+    template <size_t Probe, class V, class Scope, class T, typename... Rest>
+    inline bool visit(V *visitable, TypeList<T, Rest...>, RecursiveVisitorBase &visitor,
+                      Scope &scope) {
+      if (auto *v = visitor.asVisitorFor<T>()) {
+        scope.hit(Probe + 1);
+        if (v->visit(castVisitable<V, T>(visitable))) {
           return true;
         }
+      }
+      if constexpr (sizeof...(Rest) > 0) {
+        return visit<Probe + 1>(visitable, TypeList<Rest...>(), visitor, scope);
       } else {
-        if (v->visit(static_cast<T>(*visitable))) {
-          return true;
-        }
+        return false;
       }
     }
-    if constexpr (sizeof...(Rest) > 0) {
-      return visit(visitable, TypeList<Rest...>(), visitor);
-    } else {
+
+    template <size_t Probe, class V, class Scope>
+    inline bool visit(V *, TypeList<>, RecursiveVisitorBase &, Scope &) {
       return false;
     }
+
+    /**
+     * Calls the visit algorithm, recording the dispatch if visitor profiling is enabled.
+     */
+    template <class V, typename... Types, class Visitor>
+    inline decltype(auto) profiledVisit(V *visitable, TypeList<Types...> types, Visitor &visitor) {
+      if constexpr (visitor_profiling::enabled) {
+        visitor_profiling::DispatchScope<V, Visitor> scope(*visitable, visitor, sizeof...(Types));
+        return visit<0>(visitable, types, visitor, scope);
+      } else {
+        visitor_profiling::NoDispatchScope scope;
+        return visit<0>(visitable, types, visitor, scope);
+      }
+    }
+
+  }  // namespace visitor_detail
+
+  /**
+   * The regular visitor algorithm.
+   */
+  template <class V, typename... Types>
+  static void visit(V *visitable, TypeList<Types...> types, VisitorBase &visitor) {
+    visitor_detail::profiledVisit(visitable, types, visitor);
   }
 
-  template <class V> static bool visit(V *, TypeList<>, RecursiveVisitorBase &) { return false; }
+  /**
+   * The recursive visitor algorithm.
+   */
+  template <class V, typename... Types>
+  static bool visit(V *visitable, TypeList<Types...> types, RecursiveVisitorBase &visitor) {
+    return visitor_detail::profiledVisit(visitable, types, visitor);
+  }
 
   /**
    * An "empty" visitable object. When visited, no matching visitor methods will
@@ -330,12 +405,40 @@ namespace revisited {
 
   struct IndirectVisitableData {};
 
+  /**
+   * Base class for data visitables that store their data by value, i.e. with `T` equal to
+   * `BaseCast`.
+   */
+  struct InlineVisitableData {};
+
+  namespace visitor_detail {
+
+    template <class T, class BaseCast, typename = void> struct ConvertsToReference
+        : public std::false_type {};
+
+    template <class T, class BaseCast> struct ConvertsToReference<
+        T, BaseCast, std::void_t<decltype(std::declval<T &>().operator BaseCast &())>>
+        : public std::true_type {};
+
+  }  // namespace visitor_detail
+
+  /**
+   * `true`, if data of type `T` refers to an object of type `BaseCast`, i.e. `T` is derived from
+   * `BaseCast` or converts to a `BaseCast &`. Conversions that create a temporary `BaseCast` are
+   * not considered.
+   */
+  template <class T, class BaseCast> constexpr static bool IsReferencingData
+      = !std::is_same<T, typename std::remove_cv<BaseCast>::type>::value
+        && (std::is_base_of<typename std::remove_cv<BaseCast>::type, T>::value
+            || visitor_detail::ConvertsToReference<T, BaseCast>::value);
+
   /**
    * Prototype for a visitable object holding data of type `T`.
    * The template paramters `Types` and `ConstTypes` are TypeLists defining the
    * types that are visitable. `ConstTypes` is used when the accepting object is
    * const, otherwise `Types`. When accepting a visitor, `data` will be statically
-   * casted to the according type.
+   * casted to the according type. If `T` is a different type that is derived from or
+   * converts to a `BaseCast &`, `data` is considered a reference to an object of type `BaseCast`.
    */
   template <class T, class _Types, class _ConstTypes, class BaseCast = T, typename Enable = void>
   class DataVisitablePrototype;
@@ -353,7 +456,10 @@ namespace revisited {
   template <class T, class _Types, class _ConstTypes, class BaseCast>
   class DataVisitablePrototype<T, _Types, _ConstTypes, BaseCast,
                                typename std::enable_if<!std::is_abstract<T>::value>::type>
-      : public virtual VisitableBase, public IndirectVisitableBase {
+      : public virtual VisitableBase,
+        public IndirectVisitableBase,
+        public std::conditional<std::is_same<T, typename std::remove_cv<BaseCast>::type>::value,
+                                InlineVisitableData, IndirectVisitableData>::type {
   public:
     using Type = T;
     using Types = _Types;
@@ -378,9 +484,21 @@ namespace revisited {
       return getTypeID<typename std::decay<BaseCast>::type>();
     }
 
-    template <typename O> O cast() { return static_cast<O>(data); }
+    template <typename O> O cast() {
+      if constexpr (IsReferencingData<T, BaseCast> && !std::is_convertible<T &, O>::value) {
+        return static_cast<O>(static_cast<BaseCast &>(data));
+      } else {
+        return static_cast<O>(data);
+      }
+    }
 
-    template <typename O> O cast() const { return static_cast<O>(data); }
+    template <typename O> O cast() const {
+      if constexpr (IsReferencingData<T, BaseCast> && !std::is_convertible<const T &, O>::value) {
+        return static_cast<O>(static_cast<const BaseCast &>(data));
+      } else {
+        return static_cast<O>(data);
+      }
+    }
 
     operator Type &() { return data; }
 
@@ -437,7 +555,7 @@ namespace revisited {
 
   template <class T> struct CastVisitor : public Visitor<T> {
     std::optional<T> result;
-    void visit(T t) { result = t; }
+    void visit(T t) { result = std::move(t); }
   };
 
   /**
@@ -450,13 +568,13 @@ namespace revisited {
   template <class T> T visitor_cast(const VisitableBase &v) {
     CastVisitor<T> visitor;
     v.accept(visitor);
-    return *visitor.result;
+    return std::move(*visitor.result);
   }
 
   template <class T> struct OptCastVisitor : public RecursiveVisitor<T> {
     std::optional<T> result;
     bool visit(T t) {
-      result = t;
+      result = std::move(t);
       return true;
     }
   };
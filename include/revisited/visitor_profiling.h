@@ -0,0 +1,261 @@
+#pragma once
+
+#include <revisited/instrumentation.h>
+#include <revisited/type_index.h>
+#include <revisited/visitor_profiling_hooks.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace revisited {
+
+  /**
+   * Dispatch counters for visitors of type `visitorType` accepted by visitables of type
+   * `visitableType`. `probes` counts the visitable's types that have been requested from the
+   * visitor and `comparisons` the type comparisons performed by the visitor to answer them.
+   */
+  struct VisitorDispatchStatistics {
+    TypeID visitableType;
+    TypeID visitorType;
+    uint64_t calls = 0;
+    uint64_t probes = 0;
+    uint64_t comparisons = 0;
+    uint64_t maxProbes = 0;
+    uint64_t maxComparisons = 0;
+    uint64_t misses = 0;
+    uint64_t exceptions = 0;
+  };
+
+  /**
+   * The number of times each argument type of visitors of type `visitorType` has been matched,
+   * sorted by decreasing frequency.
+   */
+  struct VisitorArgumentStatistics {
+    TypeID visitorType;
+    std::vector<std::pair<TypeID, uint64_t>> hits;
+  };
+
+  /**
+   * A snapshot of the dispatch statistics of all threads, sorted by the number of calls.
+   */
+  struct VisitorStatistics {
+    std::vector<VisitorDispatchStatistics> pairs;
+    std::vector<VisitorArgumentStatistics> visitors;
+
+    /**
+     * The `count` most frequently dispatched pairs.
+     */
+    std::vector<VisitorDispatchStatistics> hottest(size_t count) const {
+      return std::vector<VisitorDispatchStatistics>(
+          pairs.begin(), pairs.begin() + std::min(count, pairs.size()));
+    }
+
+    /**
+     * The `count` pairs with the most type comparisons in a single dispatch.
+     */
+    std::vector<VisitorDispatchStatistics> deepest(size_t count) const {
+      auto result = pairs;
+      std::stable_sort(result.begin(), result.end(), [](auto &a, auto &b) {
+        return a.maxComparisons != b.maxComparisons ? a.maxComparisons > b.maxComparisons
+                                                    : a.maxProbes > b.maxProbes;
+      });
+      result.resize(std::min(count, result.size()));
+      return result;
+    }
+
+    /**
+     * Writes the statistics as a tab separated table.
+     */
+    void write(std::ostream &stream) const {
+      stream << "visitable\tvisitor\tcalls\tprobes\tcomparisons\tmax probes\tmax "
+                "comparisons\tmisses\texceptions\n";
+      for (auto &p : pairs) {
+        stream << p.visitableType.name << '\t' << p.visitorType.name << '\t' << p.calls << '\t'
+               << p.probes << '\t' << p.comparisons << '\t' << p.maxProbes << '\t'
+               << p.maxComparisons << '\t' << p.misses << '\t' << p.exceptions << '\n';
+      }
+    }
+
+    /**
+     * Writes a header specializing `VisitorDispatchOrder` for every visitor type, so that its
+     * argument types are checked in the order of their recorded frequency. The generated code
+     * uses the recorded type names, so it requires all visited types to be nameable from the
+     * global scope.
+     */
+    void writeDispatchOrder(std::ostream &stream) const {
+      stream << "#pragma once\n\n#include <revisited/visitor.h>\n\nnamespace revisited {\n";
+      for (auto &v : visitors) {
+        stream << "\n  template <> struct VisitorDispatchOrder<" << v.visitorType.name << "> {\n"
+               << "    using type = TypeList<";
+        for (size_t i = 0; i < v.hits.size(); ++i) {
+          stream << (i > 0 ? ", " : "") << v.hits[i].first.name;
+        }
+        stream << ">;\n  };\n";
+      }
+      stream << "\n}  // namespace revisited\n";
+    }
+  };
+
+  /**
+   * Opt-in profiling of visitor dispatch. The hooks in `visit()` and
+   * `VisitorPrototype::getVisitorFor` are compiled out unless `REVISITED_VISITOR_PROFILING` is
+   * defined, e.g. through the CMake option of the same name. The definition must be consistent
+   * across all translation units.
+   */
+  namespace visitor_profiling {
+
+    namespace detail {
+      struct ArgumentHits {
+        TypeID argument;
+        uint64_t count = 0;
+      };
+
+      struct Data {
+        std::unordered_map<std::pair<TypeIndex, TypeIndex>, VisitorDispatchStatistics,
+                           instrumentation_detail::PairHash>
+            pairs;
+        std::unordered_map<std::pair<TypeIndex, TypeIndex>, ArgumentHits,
+                           instrumentation_detail::PairHash>
+            arguments;
+      };
+
+      using Recorder = instrumentation_detail::ThreadLocalRecorder<Data>;
+    }  // namespace detail
+
+    /**
+     * Records a single dispatch.
+     */
+    inline void recordDispatch(const TypeID &visitable, const TypeID &visitor, uint64_t probes,
+                               uint64_t comparisons, bool hit, bool exception,
+                               const TypeID &argument = getTypeID<void>()) {
+      detail::Recorder::record([&](detail::Data &data) {
+        if (hit) {
+          auto &hits = data.arguments[std::make_pair(visitor.index, argument.index)];
+          hits.argument = argument;
+          hits.count++;
+        }
+        auto &stats = data.pairs[std::make_pair(visitable.index, visitor.index)];
+        stats.visitableType = visitable;
+        stats.visitorType = visitor;
+        stats.calls++;
+        stats.probes += probes;
+        stats.comparisons += comparisons;
+        stats.maxProbes = std::max<uint64_t>(stats.maxProbes, probes);
+        stats.maxComparisons = std::max<uint64_t>(stats.maxComparisons, comparisons);
+        stats.misses += !hit;
+        stats.exceptions += exception;
+      });
+    }
+
+    /**
+     * Records the dispatch of `visitor` on `visitable` when leaving the scope.
+     * `hit` should be called when a visit method is found after probing `probes` types.
+     */
+    template <class V, class Visitor> class DispatchScope {
+    private:
+      const V &visitable;
+      Visitor &visitor;
+      uint64_t probes;
+      uint64_t savedComparisons;
+      int uncaughtExceptions;
+      TypeID argument = getTypeID<void>();
+      bool found = false;
+
+    public:
+      DispatchScope(const V &_visitable, Visitor &_visitor, uint64_t typeCount)
+          : visitable(_visitable),
+            visitor(_visitor),
+            probes(typeCount),
+            savedComparisons(std::exchange(detail::comparisons(), 0)),
+            uncaughtExceptions(std::uncaught_exceptions()) {}
+
+      DispatchScope(const DispatchScope &) = delete;
+      DispatchScope &operator=(const DispatchScope &) = delete;
+
+      void hit(uint64_t _probes) {
+        probes = _probes;
+        argument = detail::matchedArgument();
+        found = true;
+      }
+
+      ~DispatchScope() {
+        auto comparisons = std::exchange(detail::comparisons(), savedComparisons);
+        recordDispatch(visitable.visitableType(), visitor.visitorType(), probes, comparisons,
+                       found, found && std::uncaught_exceptions() > uncaughtExceptions, argument);
+      }
+    };
+
+    /**
+     * Merges the statistics recorded by all threads.
+     */
+    inline VisitorStatistics snapshot() {
+      detail::Data merged;
+      detail::Recorder::forEach([&](const detail::Data &data) {
+        for (auto &[key, hits] : data.arguments) {
+          auto &target = merged.arguments[key];
+          target.argument = hits.argument;
+          target.count += hits.count;
+        }
+        for (auto &[key, stats] : data.pairs) {
+          auto &target = merged.pairs[key];
+          target.visitableType = stats.visitableType;
+          target.visitorType = stats.visitorType;
+          target.calls += stats.calls;
+          target.probes += stats.probes;
+          target.comparisons += stats.comparisons;
+          target.maxProbes = std::max(target.maxProbes, stats.maxProbes);
+          target.maxComparisons = std::max(target.maxComparisons, stats.maxComparisons);
+          target.misses += stats.misses;
+          target.exceptions += stats.exceptions;
+        }
+      });
+
+      VisitorStatistics result;
+      for (auto &[key, stats] : merged.pairs) {
+        result.pairs.push_back(stats);
+      }
+
+      std::unordered_map<TypeIndex, size_t> visitorPositions;
+      for (auto &[key, stats] : merged.pairs) {
+        if (visitorPositions.emplace(key.second, result.visitors.size()).second) {
+          result.visitors.push_back(VisitorArgumentStatistics{stats.visitorType, {}});
+        }
+      }
+      for (auto &[key, hits] : merged.arguments) {
+        auto &visitor = result.visitors[visitorPositions[key.first]];
+        visitor.hits.emplace_back(hits.argument, hits.count);
+      }
+      for (auto &visitor : result.visitors) {
+        std::sort(visitor.hits.begin(), visitor.hits.end(), [](auto &a, auto &b) {
+          return a.second != b.second ? a.second > b.second : a.first.index < b.first.index;
+        });
+      }
+      result.visitors.erase(std::remove_if(result.visitors.begin(), result.visitors.end(),
+                                           [](auto &v) { return v.hits.empty(); }),
+                            result.visitors.end());
+      std::sort(result.visitors.begin(), result.visitors.end(),
+                [](auto &a, auto &b) { return a.visitorType.index < b.visitorType.index; });
+
+      std::sort(result.pairs.begin(), result.pairs.end(), [](auto &a, auto &b) {
+        if (a.calls != b.calls) {
+          return a.calls > b.calls;
+        }
+        return std::make_pair(a.visitableType.index, a.visitorType.index)
+               < std::make_pair(b.visitableType.index, b.visitorType.index);
+      });
+      return result;
+    }
+
+    /**
+     * Clears the statistics recorded by all threads.
+     */
+    inline void reset() { detail::Recorder::reset(); }
+
+  }  // namespace visitor_profiling
+
+}  // namespace revisited
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <revisited/type_index.h>
+
+#include <cstdint>
+
+namespace revisited {
+
+  /**
+   * The parts of the visitor profiling that are called by `visit()` and
+   * `VisitorPrototype::getVisitorFor`. The statistics themselves are defined in
+   * `revisited/visitor_profiling.h`, which `revisited/visitor.h` only includes if
+   * `REVISITED_VISITOR_PROFILING` is defined.
+   */
+  namespace visitor_profiling {
+
+#ifdef REVISITED_VISITOR_PROFILING
+    constexpr bool enabled = true;
+#else
+    constexpr bool enabled = false;
+#endif
+
+    namespace detail {
+      /**
+       * The type comparisons performed by `getVisitorFor` in the current thread.
+       */
+      inline uint64_t &comparisons() {
+        thread_local uint64_t value = 0;
+        return value;
+      }
+
+      /**
+       * The argument type last matched by `getVisitorFor` in the current thread.
+       */
+      inline TypeID &matchedArgument() {
+        thread_local TypeID value = getTypeID<void>();
+        return value;
+      }
+    }  // namespace detail
+
+    /**
+     * Called by visitors after comparing `count` types in `getVisitorFor`.
+     */
+    inline void addComparisons(uint64_t count) { detail::comparisons() += count; }
+
+    /**
+     * Called by visitors after matching the argument type `argument` in `getVisitorFor`.
+     */
+    inline void setMatchedArgument(const TypeID &argument) {
+      detail::matchedArgument() = argument;
+    }
+
+    template <class V, class Visitor> class DispatchScope;
+
+    /**
+     * Used in place of `DispatchScope` when profiling is disabled.
+     */
+    struct NoDispatchScope {
+      void hit(uint64_t) {}
+    };
+
+  }  // namespace visitor_profiling
+
+}  // namespace revisited
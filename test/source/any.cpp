@@ -97,6 +97,64 @@ TEST_CASE("Any string conversions") {
   CHECK(v.tryGet<int>() == nullptr);
 }
 
+TEST_CASE("string views") {
+  SUBCASE("literals") {
+    Any v = literal("literal");
+    CHECK(v.type() == getTypeID<std::string>());
+    CHECK(v.get<std::string_view>() == "literal");
+    CHECK(v.get<std::string>() == "literal");
+    v.get<std::string &>() += "!";
+    CHECK(v.get<std::string_view>() == "literal!");
+    CHECK(v.get<const std::string &>() == "literal!");
+  }
+
+  SUBCASE("literals are not copied") {
+    static const char value[] = "static literal";
+    Any v = literal(value);
+    CHECK(v.get<std::string_view>().data() == value);
+    CHECK(v.get<const std::string &>().data() != value);
+  }
+
+  SUBCASE("literals keep null characters") {
+    Any v = literal("a\0b");
+    CHECK(v.get<std::string_view>().size() == 3);
+    CHECK(v.get<std::string>() == std::string("a\0b", 3));
+  }
+
+  SUBCASE("const char arrays are copied") {
+    Any v;
+    {
+      const char name[] = "name";
+      v = name;
+      CHECK(v.get<std::string_view>().data() != name);
+    }
+    CHECK(v.get<std::string_view>() == "name");
+  }
+
+  SUBCASE("char arrays are copied") {
+    char buffer[] = "abc";
+    Any v = buffer;
+    buffer[0] = 'x';
+    CHECK(v.get<std::string_view>() == "abc");
+  }
+
+  SUBCASE("strings") {
+    Any v = std::string("abc");
+    CHECK(v.get<std::string_view>().data() == v.get<const std::string &>().data());
+    std::string s = "ref";
+    v = std::reference_wrapper<std::string>(s);
+    CHECK(v.get<std::string_view>().data() == s.data());
+  }
+
+  SUBCASE("string views") {
+    std::string_view view = "view";
+    Any v = view;
+    CHECK(v.type() == getTypeID<std::string_view>());
+    CHECK(v.get<std::string_view>().data() == view.data());
+    CHECK(v.get<std::string>() == "view");
+  }
+}
+
 TEST_CASE_TEMPLATE("Numerics", TestType, char, unsigned char, short int, unsigned short int, int,
                    unsigned int, long int, unsigned long int, long long int, unsigned long long int,
                    float, double, long double) {
@@ -126,6 +184,185 @@ TEST_CASE("floating point conversions") {
   CHECK(v.get<float>() == doctest::Approx(3.141));
 }
 
+TEST_CASE("assign") {
+  Any v = 1;
+  auto address = &v.get<int &>();
+
+  SUBCASE("same type") {
+    v.assign(2);
+    CHECK(v.get<int>() == 2);
+    CHECK(&v.get<int &>() == address);
+  }
+
+  SUBCASE("other type") {
+    v.assign(2.5);
+    CHECK(v.type() == getTypeID<double>());
+    CHECK(v.get<double>() == 2.5);
+    v.assign("a");
+    CHECK(v.get<std::string>() == "a");
+    v.assign(Any(3));
+    CHECK(v.get<int>() == 3);
+  }
+
+  SUBCASE("shared value") {
+    Any w = v;
+    v.assign(2);
+    CHECK(v.get<int>() == 2);
+    CHECK(w.get<int>() == 1);
+  }
+
+  SUBCASE("empty") {
+    Any w;
+    w.assign(2);
+    CHECK(w.get<int>() == 2);
+  }
+
+  SUBCASE("reference") {
+    int x = 1;
+    Any w = std::reference_wrapper<int>(x);
+    w.assign(2);
+    CHECK(w.get<int>() == 2);
+    CHECK(x == 1);
+    const int y = 1;
+    w = std::reference_wrapper<const int>(y);
+    w.assign(3);
+    CHECK(w.get<int>() == 3);
+    CHECK(y == 1);
+  }
+
+  SUBCASE("shared pointer") {
+    auto x = std::make_shared<int>(1);
+    Any w = x;
+    w.assign(2);
+    CHECK(w.get<int>() == 2);
+    CHECK(*x == 1);
+  }
+}
+
+TEST_CASE("type tags") {
+  struct Base {};
+  struct Derived : Base {};
+
+  auto route = [](const Any &v) {
+    switch (v.typeTag()) {
+      case getTypeIndex<int>():
+        return 1;
+      case getTypeIndex<std::string>():
+        return 2;
+      case getTypeIndex<void>():
+        return 0;
+      default:
+        return -1;
+    }
+  };
+
+  Any v;
+  CHECK(v.typeTag() == getTypeIndex<void>());
+  CHECK(v.is<void>());
+  CHECK(!v.is<int>());
+  CHECK(!v.isA<int>());
+  CHECK(route(v) == 0);
+
+  v = 42;
+  CHECK(v.typeTag() == v.type().index);
+  CHECK(v.is<int>());
+  CHECK(v.is<const int &>());
+  CHECK(!v.is<double>());
+  CHECK(!v.isA<double>());
+  CHECK(route(v) == 1);
+
+  v = "message";
+  CHECK(v.is<std::string>());
+  CHECK(route(v) == 2);
+
+  v.setWithBases<Derived, Base>();
+  CHECK(v.is<Derived>());
+  CHECK(!v.is<Base>());
+  CHECK(v.isA<Base>());
+  CHECK(v.isA<const Derived>());
+  CHECK(route(v) == -1);
+
+  Any w = std::move(v);
+  CHECK(w.is<Derived>());
+  CHECK(v.is<void>());
+  v.setReference(w);
+  CHECK(v.is<Derived>());
+  w.reset();
+  CHECK(w.typeTag() == getTypeIndex<void>());
+  CHECK(w.take<Any>().is<void>());
+  CHECK(v.take<Any>().is<Derived>());
+  CHECK(v.is<void>());
+}
+
+TEST_CASE("take") {
+  Any v = std::string(100, 'x');
+
+  SUBCASE("owned") {
+    auto data = v.get<const std::string &>().data();
+    auto s = v.take<std::string>();
+    CHECK(s.size() == 100);
+    CHECK(s.data() == data);
+    CHECK(!v);
+  }
+
+  SUBCASE("shared") {
+    Any w = v;
+    auto s = v.take<std::string>();
+    CHECK(s.size() == 100);
+    CHECK(!v);
+    CHECK(w.get<const std::string &>().size() == 100);
+  }
+
+  SUBCASE("referenced") {
+    std::string s = "abc";
+    v = std::reference_wrapper<std::string>(s);
+    CHECK(v.take<std::string>() == "abc");
+    CHECK(s == "abc");
+  }
+
+  SUBCASE("converted") {
+    v = 2;
+    CHECK(v.take<double>() == 2);
+    CHECK(!v);
+  }
+
+  SUBCASE("any") {
+    auto w = v.take<Any>();
+    CHECK(!v);
+    CHECK(w.get<std::string>().size() == 100);
+  }
+
+  SUBCASE("empty") {
+    v.reset();
+    CHECK_THROWS_AS(v.take<std::string>(), UndefinedAnyException);
+  }
+}
+
+TEST_CASE("emplace") {
+  Any v;
+  CHECK(v.emplace<std::string>(3, 'a') == "aaa");
+  auto address = &v.get<std::string &>();
+
+  SUBCASE("same type") {
+    auto &value = v.emplace<std::string>("b");
+    CHECK(&value == address);
+    CHECK(v.get<std::string>() == "b");
+  }
+
+  SUBCASE("other type") {
+    CHECK(v.emplace<int>(1) == 1);
+    CHECK(v.type() == getTypeID<int>());
+  }
+
+  SUBCASE("shared value") {
+    Any w = v;
+    v.emplace<std::string>("b");
+    CHECK(&v.get<std::string &>() != address);
+    CHECK(v.get<std::string>() == "b");
+    CHECK(w.get<std::string>() == "aaa");
+  }
+}
+
 TEST_CASE("String") {
   Any v;
   CHECK_THROWS_AS(v.get<std::string>(), UndefinedAnyException);
@@ -245,6 +482,45 @@ TEST_CASE("capture const reference") {
   CHECK(y.get<double>() == 1);
 }
 
+TEST_CASE("own captured values") {
+  SUBCASE("references") {
+    int x = 1;
+    Any y = std::reference_wrapper<int>(x);
+    y.ownValue();
+    x = 2;
+    CHECK(y.is<int>());
+    CHECK(y.get<int>() == 1);
+    y.get<int &>() = 3;
+    CHECK(x == 2);
+  }
+
+  SUBCASE("const references") {
+    std::string x = "a";
+    Any y = std::reference_wrapper<const std::string>(x);
+    y.ownValue();
+    x = "b";
+    CHECK(y.get<std::string &>() == "a");
+  }
+
+  SUBCASE("owned values") {
+    Any x = 1;
+    Any y = x;
+    y.ownValue();
+    CHECK(&y.get<int &>() == &x.get<int &>());
+  }
+
+  SUBCASE("non-copyable references") {
+    struct MoveOnly {
+      MoveOnly() = default;
+      MoveOnly(MoveOnly &&) = default;
+      MoveOnly(const MoveOnly &) = delete;
+    };
+    MoveOnly x;
+    Any y = std::reference_wrapper<MoveOnly>(x);
+    CHECK_THROWS_AS(y.ownValue(), InvalidVisitorException);
+  }
+}
+
 TEST_CASE("AnyReference") {
   Any x = 1;
   AnyReference y;
@@ -3,6 +3,26 @@
 
 using namespace revisited;
 
+namespace {
+  struct HandledObject {
+    int value;
+    int get() const { return value; }
+  };
+
+  /**
+   * A handle that converts to the object it owns, which is not stored in the visitable.
+   */
+  struct ObjectHandle {
+    std::shared_ptr<HandledObject> object;
+    operator HandledObject &() const { return *object; }
+  };
+}  // namespace
+
+template <> struct revisited::AnyVisitable<ObjectHandle> {
+  using type = revisited::DataVisitablePrototype<ObjectHandle, TypeList<HandledObject &>,
+                                                 TypeList<const HandledObject &>>;
+};
+
 TEST_CASE("call without arguments") {
   AnyFunction f;
   REQUIRE(bool(f) == false);
@@ -167,6 +187,14 @@ TEST_CASE("Automatic Casting") {
     REQUIRE(f(B(), C()).get<const A &>().value == 3);
     REQUIRE(f(std::make_shared<B>(), std::make_shared<C>()).get<A &>().value == 3);
   }
+
+  SUBCASE("batch calls with base references") {
+    AnyFunction f = [](const A &x) { return x.value; };
+    std::vector<Any> values{C(), C()};
+    std::vector<int> results(2);
+    f.callBatch({values}, results);
+    REQUIRE(results == std::vector<int>{2, 2});
+  }
 }
 
 TEST_CASE("non copy-constructable class") {
@@ -223,4 +251,278 @@ TEST_CASE("return abstract pointer") {
   AnyFunction g = [](std::shared_ptr<A> a) { return a->f(); };
 
   CHECK(g(f()).get<int>() == 45);
-}
\ No newline at end of file
+}
+TEST_CASE("batch calls") {
+  AnyFunction f = [](int a, double b) { return a * b; };
+  std::vector<int> a{1, 2, 3};
+
+  SUBCASE("typed columns") {
+    std::vector<double> b{0.5, 1.5, 2.5};
+    std::vector<double> results(3);
+    f.callBatch({a, b}, results);
+    CHECK(results == std::vector<double>{0.5, 3, 7.5});
+  }
+
+  SUBCASE("converted columns") {
+    std::vector<float> b{0.5, 1.5, 2.5};
+    std::vector<int> results(3);
+    f.callBatch({a, b}, results);
+    CHECK(results == std::vector<int>{0, 3, 7});
+  }
+
+  SUBCASE("any columns") {
+    std::vector<Any> b{0.5, 1, 2.5f};
+    std::vector<Any> results(3);
+    f.callBatch({a, b}, results);
+    CHECK(results[0].get<double>() == 0.5);
+    CHECK(results[1].get<double>() == 2);
+    CHECK(results[2].get<double>() == 7.5);
+  }
+
+  SUBCASE("any columns of a single type are read in place") {
+    std::vector<Any> b{0.5, 1.5, 2.5};
+    std::vector<const double *> addresses;
+    AnyFunction g = [&](int a, const double &b) {
+      addresses.push_back(&b);
+      return a * b;
+    };
+    std::vector<double> results(3);
+    g.callBatch({a, b}, results);
+    CHECK(results == std::vector<double>{0.5, 3, 7.5});
+    REQUIRE(addresses.size() == 3);
+    for (size_t i = 0; i < 3; ++i) {
+      CHECK(addresses[i] == &b[i].get<const double &>());
+    }
+  }
+
+  SUBCASE("any results are replaced") {
+    std::vector<double> b{0.5, 1.5, 2.5};
+    double x = 0;
+    std::vector<Any> results{std::reference_wrapper<double>(x), 0.0, 0.0};
+    Any shared = results[1];
+    f.callBatch({a, b}, results);
+    CHECK(results[0].get<double>() == 0.5);
+    CHECK(results[1].get<double>() == 3);
+    CHECK(x == 0);
+    CHECK(shared.get<double>() == 0);
+  }
+
+  SUBCASE("discard results") {
+    int count = 0;
+    AnyFunction g = [&](int) { count++; };
+    g.callBatch({a});
+    CHECK(count == 3);
+    f.callBatch({a, a});
+  }
+
+  SUBCASE("invalid calls") {
+    std::vector<double> results(2);
+    std::vector<std::string> strings{"a", "b", "c"};
+    CHECK_THROWS_AS(f.callBatch({a}), AnyFunctionInvalidArgumentCountException);
+    CHECK_THROWS_AS(f.callBatch({a, a}, results), AnyFunctionInvalidBatchSizeException);
+    CHECK_THROWS_AS(f.callBatch({a, std::vector<int>{1}}), AnyFunctionInvalidBatchSizeException);
+    CHECK_THROWS_AS(f.callBatch({a, strings}), InvalidVisitorException);
+    CHECK_THROWS_AS(AnyFunction().callBatch({}), UndefinedAnyFunctionException);
+  }
+}
+
+TEST_CASE("batch calls with references") {
+  std::vector<std::string> strings{"a", "b"};
+
+  SUBCASE("mutable reference") {
+    AnyFunction f = [](std::string &s) { s += "!"; };
+    f.callBatch({strings});
+    CHECK(strings == std::vector<std::string>{"a!", "b!"});
+    const auto &constStrings = strings;
+    CHECK_THROWS_AS(f.callBatch({constStrings}), InvalidVisitorException);
+  }
+
+  SUBCASE("const reference") {
+    AnyFunction f = [](const std::string &s) { return s.size(); };
+    std::vector<size_t> results(2);
+    f.callBatch({strings}, results);
+    CHECK(results == std::vector<size_t>{1, 1});
+  }
+
+  SUBCASE("variadic") {
+    AnyFunction f = [](const AnyArguments &args) { return args[0].get<std::string>() + "?"; };
+    std::vector<std::string> results(2);
+    f.callBatch({strings}, results);
+    CHECK(results == std::vector<std::string>{"a?", "b?"});
+  }
+}
+
+TEST_CASE("call into result") {
+  AnyFunction f = [](int a, int b) { return a + b; };
+
+  SUBCASE("any") {
+    Any result = 0;
+    auto address = &result.get<int &>();
+    f.callInto({1, 2}, result);
+    CHECK(result.get<int>() == 3);
+    CHECK(&result.get<int &>() == address);
+    Any empty;
+    f.callInto({2, 2}, empty);
+    CHECK(empty.get<int>() == 4);
+  }
+
+  SUBCASE("typed") {
+    int result = 0;
+    f.callInto({1, 2}, result);
+    CHECK(result == 3);
+    double converted = 0;
+    f.callInto({1, 3}, converted);
+    CHECK(converted == 4);
+    CHECK_THROWS_AS(f.callInto({1}, result), AnyFunctionInvalidArgumentCountException);
+    CHECK_THROWS_AS(AnyFunction().callInto({}, result), UndefinedAnyFunctionException);
+  }
+
+  SUBCASE("reference") {
+    int x = 0;
+    Any result = std::reference_wrapper<int>(x);
+    f.callInto({1, 2}, result);
+    CHECK(result.get<int>() == 3);
+    CHECK(x == 0);
+  }
+
+  SUBCASE("variadic and void") {
+    AnyFunction g = [](const AnyArguments &args) { return args.size(); };
+    size_t size = 0;
+    g.callInto({1, 2}, size);
+    CHECK(size == 2);
+    AnyFunction h = []() {};
+    Any result = 1;
+    h.callInto({}, result);
+    CHECK(result.get<int>() == 1);
+  }
+}
+
+TEST_CASE("member pointers") {
+  struct A {
+    int a = 1;
+    int getA() const { return a; }
+    void setA(int v) { a = v; }
+  };
+  struct B {
+    int b = 2;
+    int add(int x) const noexcept { return b + x; }
+  };
+  struct C : public A, public B {
+    int c = 3;
+  };
+
+  AnyFunction getA = &A::getA;
+  AnyFunction setA = &A::setA;
+  AnyFunction add = &B::add;
+  AnyFunction b = &B::b;
+
+  CHECK(getA.argumentCount() == 1);
+  CHECK(add.argumentCount() == 2);
+  CHECK(add.returnType() == getTypeID<int>());
+  CHECK(add.argumentType(1) == getTypeID<int>());
+
+  SUBCASE("values") {
+    A x;
+    auto y = Any::withBases<C, A, B>();
+    C z;
+    for (int i = 0; i < 2; ++i) {
+      setA(x, 4);
+      CHECK(getA(x).get<int>() == 4);
+      CHECK(x.a == 4);
+      CHECK(add(y, 3).get<int>() == 5);
+      CHECK(b(y).get<int>() == 2);
+      setA(y, 5);
+      CHECK(getA(y).get<int>() == 5);
+      CHECK(getA(Any(std::make_shared<A>())).get<int>() == 1);
+      z.b = i;
+      CHECK(add(Any::withBases<C, A, B>(z), 1).get<int>() == i + 1);
+    }
+  }
+
+  SUBCASE("visitable") {
+    struct D : public Visitable<D> {
+      int d = 0;
+      int get() const { return d; }
+    };
+    struct E : public DerivedVisitable<E, D> {};
+    AnyFunction get = &D::get;
+    D d;
+    d.d = 3;
+    CHECK(get(d).get<int>() == 3);
+    CHECK(get(Any(std::make_shared<D>())).get<int>() == 0);
+    CHECK(get(makeAny<E>()).get<int>() == 0);
+  }
+
+  SUBCASE("handles") {
+    AnyFunction get = &HandledObject::get;
+    Any x = ObjectHandle{std::make_shared<HandledObject>(HandledObject{1})};
+    Any y = ObjectHandle{std::make_shared<HandledObject>(HandledObject{2})};
+    for (int i = 0; i < 2; ++i) {
+      CHECK(get(x).get<int>() == 1);
+      CHECK(get(y).get<int>() == 2);
+    }
+  }
+
+  SUBCASE("invalid objects") {
+    CHECK_THROWS_AS(getA(B()), InvalidVisitorException);
+    CHECK_THROWS_AS(getA(Any()), UndefinedAnyException);
+    CHECK_THROWS_AS(getA(), AnyFunctionInvalidArgumentCountException);
+    const A x;
+    CHECK(getA(x).get<int>() == 1);
+    CHECK_THROWS_AS(setA(x, 2), InvalidVisitorException);
+  }
+}
+
+TEST_CASE("move arguments") {
+  struct Payload {
+    int *copies;
+    explicit Payload(int *c) : copies(c) {}
+    Payload(const Payload &other) : copies(other.copies) { ++*copies; }
+    Payload(Payload &&other) = default;
+    Payload &operator=(const Payload &) = default;
+    Payload &operator=(Payload &&) = default;
+  };
+
+  int copies = 0;
+  AnyFunction byValue = [](Payload p) { return p.copies != nullptr; };
+  AnyFunction byRvalue = [](Payload &&p) {
+    Payload q = std::move(p);
+    return q.copies != nullptr;
+  };
+  AnyFunction byReference = [](const Payload &p) { return p.copies != nullptr; };
+
+  SUBCASE("rvalues") {
+    CHECK(byValue(Payload(&copies)).get<bool>());
+    CHECK(byRvalue(Payload(&copies)).get<bool>());
+    CHECK(byReference(Payload(&copies)).get<bool>());
+    CHECK(copies == 0);
+  }
+
+  SUBCASE("lvalues are copied") {
+    Payload p(&copies);
+    CHECK(byValue(p).get<bool>());
+    CHECK(byRvalue(p).get<bool>());
+    CHECK(copies == 2);
+    CHECK(p.copies == &copies);
+  }
+
+  SUBCASE("owned arguments") {
+    AnyArguments args{Any(Payload(&copies))};
+    CHECK(byValue.call(args).get<bool>());
+    CHECK(copies == 1);
+    CHECK(byValue.call(std::move(args)).get<bool>());
+    CHECK(copies == 1);
+
+    Any shared = Payload(&copies);
+    CHECK(byValue.call(AnyArguments{shared}).get<bool>());
+    CHECK(copies == 2);
+    CHECK(shared.get<const Payload &>().copies == &copies);
+  }
+
+  SUBCASE("strings") {
+    AnyFunction f = [](std::string s) { return s.size(); };
+    std::string s(100, 'x');
+    CHECK(f(std::move(s)).get<size_t>() == 100);
+    CHECK(s.empty());
+  }
+}
@@ -0,0 +1,46 @@
+#include <doctest/doctest.h>
+#include <revisited/any_hash.h>
+
+#include <unordered_map>
+
+using namespace revisited;
+
+TEST_CASE("hash values") {
+  CHECK(hashValue(42) == std::hash<int>()(42));
+  CHECK(hashValue(std::string("a")) == std::hash<std::string>()("a"));
+  CHECK(hashValue("a") == std::hash<std::string>()("a"));
+  CHECK(hashValue(Any()) == 0);
+
+  int x = 42;
+  CHECK(hashValue(std::reference_wrapper<int>(x)) == hashValue(42));
+
+  struct A {};
+  CHECK(!tryHashValue(A()));
+  CHECK_THROWS_AS(hashValue(A()), InvalidVisitorException);
+}
+
+TEST_CASE("compare values") {
+  CHECK(equalValues(1, 1));
+  CHECK(!equalValues(1, 2));
+  CHECK(!equalValues(1, 1.0));
+  CHECK(equalValues("a", std::string("a")));
+  CHECK(equalValues(Any(), Any()));
+  CHECK(!equalValues(Any(), 1));
+  CHECK(!equalValues(1, Any()));
+
+  struct A {};
+  Any a = A();
+  CHECK(!equalValues(a, a));
+}
+
+TEST_CASE("any values as keys") {
+  std::unordered_map<Any, int, AnyValueHash, AnyValueEqual> map;
+  map[1] = 1;
+  map["a"] = 2;
+  map[true] = 3;
+  CHECK(map.size() == 3);
+  CHECK(map[1] == 1);
+  CHECK(map[std::string("a")] == 2);
+  CHECK(map[true] == 3);
+  CHECK(map.find(1.0) == map.end());
+}
@@ -0,0 +1,80 @@
+#include <doctest/doctest.h>
+#include <revisited/any.h>
+
+#include <sstream>
+#include <thread>
+
+using namespace revisited;
+
+namespace {
+  const AnyTypeStatistics *findType(const AnyStatistics &stats, const TypeID &type) {
+    for (auto &t : stats.types) {
+      if (t.type == type) {
+        return &t;
+      }
+    }
+    return nullptr;
+  }
+}  // namespace
+
+TEST_CASE("any instrumentation") {
+  any_instrumentation::reset();
+
+  SUBCASE("recording") {
+    std::thread([]() {
+      any_instrumentation::recordAllocation(getTypeID<int>(), 16);
+      any_instrumentation::recordCast(getTypeID<int>(), getTypeID<double>(), true);
+    }).join();
+    any_instrumentation::recordAllocation(getTypeID<int>(), 16);
+    any_instrumentation::recordAllocation(getTypeID<float>(), 8);
+    any_instrumentation::recordCast(getTypeID<int>(), getTypeID<int>(), true);
+    any_instrumentation::recordCast(getTypeID<int>(), getTypeID<double>(), false);
+
+    auto stats = any_instrumentation::snapshot();
+    REQUIRE(stats.types.size() == 2);
+    CHECK(stats.types[0].type == getTypeID<int>());
+    CHECK(stats.types[0].allocations == 2);
+    CHECK(stats.types[0].allocatedBytes == 32);
+    CHECK(stats.types[0].exactCasts == 1);
+    CHECK(stats.types[0].convertedCasts == 1);
+    CHECK(stats.types[0].failedCasts == 1);
+    CHECK(stats.types[1].type == getTypeID<float>());
+    REQUIRE(stats.conversions.size() == 1);
+    CHECK(stats.conversions[0].source == getTypeID<int>());
+    CHECK(stats.conversions[0].target == getTypeID<double>());
+    CHECK(stats.conversions[0].count == 2);
+    CHECK(stats.conversions[0].failures == 1);
+
+    std::stringstream stream;
+    stats.write(stream);
+    CHECK(stream.str().find(std::string(getTypeID<float>().name) + "\t1\t8\t0\t0\t0\n")
+          != std::string::npos);
+
+    any_instrumentation::reset();
+    CHECK(any_instrumentation::snapshot().types.size() == 0);
+  }
+
+  SUBCASE("any hooks") {
+    Any v = 1;
+    CHECK(v.get<int>() == 1);
+    CHECK(v.get<double>() == 1);
+    CHECK(v.as<const int &>());
+    CHECK(!v.as<std::string>());
+    CHECK_THROWS(v.get<std::string>());
+
+    auto stats = any_instrumentation::snapshot();
+    if constexpr (any_instrumentation::enabled) {
+      auto intStats = findType(stats, getTypeID<int>());
+      REQUIRE(intStats);
+      CHECK(intStats->allocations == 1);
+      CHECK(intStats->allocatedBytes > 0);
+      CHECK(intStats->exactCasts == 2);
+      CHECK(intStats->convertedCasts == 1);
+      CHECK(intStats->failedCasts == 2);
+      CHECK(stats.conversions.size() == 2);
+    } else {
+      CHECK(stats.types.size() == 0);
+      CHECK(stats.conversions.size() == 0);
+    }
+  }
+}
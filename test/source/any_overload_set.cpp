@@ -0,0 +1,133 @@
+#include <doctest/doctest.h>
+#include <revisited/any_overload_set.h>
+
+using namespace revisited;
+
+TEST_CASE("overload resolution") {
+  AnyOverloadSet f{
+      [](double x) { return "double " + std::to_string(int(x)); },
+      [](int x) { return "int " + std::to_string(x); },
+      [](const std::string &x) { return "string " + x; },
+      [](int x, int y) { return "ints " + std::to_string(x + y); },
+  };
+
+  REQUIRE(f.size() == 4);
+  CHECK(f(1).get<std::string>() == "int 1");
+  CHECK(f(1.5).get<std::string>() == "double 1");
+  CHECK(f(1.5f).get<std::string>() == "double 1");
+  CHECK(f("a").get<std::string>() == "string a");
+  CHECK(f(1, 2.5).get<std::string>() == "ints 3");
+  CHECK_THROWS_AS(f(), NoMatchingOverloadException);
+  CHECK_THROWS_AS(f(1, 2, 3), NoMatchingOverloadException);
+  CHECK_THROWS_WITH(f(1, "a"), "no matching overload for arguments");
+
+  SUBCASE("cached plans") {
+    auto plan = f.resolve(AnyArguments{1});
+    REQUIRE(plan);
+    CHECK(plan->overload == 1);
+    CHECK(plan->conversions == std::vector<ArgumentConversion>{ArgumentConversion::Exact});
+    CHECK(f.resolve(AnyArguments{2})->overload == 1);
+    plan = f.resolve(AnyArguments{1.5f});
+    REQUIRE(plan);
+    CHECK(plan->overload == 0);
+    CHECK(plan->conversions == std::vector<ArgumentConversion>{ArgumentConversion::Promotion});
+    CHECK(!f.resolve(AnyArguments{Any()}));
+  }
+
+  SUBCASE("add overload") {
+    f.add([](float) { return std::string("float"); });
+    CHECK(f(1.5f).get<std::string>() == "float");
+    CHECK_THROWS_AS(f.add(AnyFunction()), UndefinedAnyFunctionException);
+  }
+
+  SUBCASE("as any function") {
+    AnyFunction g = f.function();
+    CHECK(g.isVariadic());
+    CHECK(g(2).get<std::string>() == "int 2");
+    CHECK(g("b").get<std::string>() == "string b");
+  }
+}
+
+TEST_CASE("overload resolution prefers promotions") {
+  AnyOverloadSet f{
+      [](int) { return std::string("int"); },
+      [](double) { return std::string("double"); },
+  };
+  CHECK(f(42).get<std::string>() == "int");
+  CHECK(f(4.2f).get<std::string>() == "double");
+  CHECK(f(4.2).get<std::string>() == "double");
+  CHECK(f(short(1)).get<std::string>() == "int");
+  CHECK(f(1u).get<std::string>() == "double");
+  CHECK(f.resolve(AnyArguments{4.2f})->conversions
+        == std::vector<ArgumentConversion>{ArgumentConversion::Promotion});
+
+  AnyOverloadSet g{
+      [](float) { return std::string("float"); },
+      [](long long) { return std::string("long long"); },
+  };
+  CHECK(g(1).get<std::string>() == "long long");
+  CHECK(g(1.5).get<std::string>() == "float");
+}
+
+TEST_CASE("overload resolution with inheritance") {
+  struct A : public Visitable<A> {};
+  struct B : public DerivedVisitable<B, A> {};
+  struct C : public DerivedVisitable<C, B> {};
+
+  AnyOverloadSet f{
+      [](A &) { return 'A'; },
+      [](B &) { return 'B'; },
+      [](const Any &) { return '?'; },
+      [](const AnyArguments &) { return '*'; },
+  };
+
+  CHECK(f(A()).get<char>() == 'A');
+  CHECK(f(B()).get<char>() == 'B');
+  CHECK(f(std::make_shared<B>()).get<char>() == 'B');
+  CHECK(f(42).get<char>() == '?');
+  CHECK(f().get<char>() == '*');
+  CHECK(f(1, 2).get<char>() == '*');
+
+  auto plan = f.resolve(AnyArguments{C()});
+  REQUIRE(plan);
+  CHECK(plan->conversions == std::vector<ArgumentConversion>{ArgumentConversion::BaseCast});
+
+  SUBCASE("plans depend on stored bases") {
+    struct Base {};
+    struct Derived : public Base {};
+    AnyOverloadSet g{
+        [](Base &) { return 'B'; },
+        [](const Any &) { return '?'; },
+    };
+    CHECK(g(Any::withBases<Derived, Base>()).get<char>() == 'B');
+    CHECK(g(Any(Derived())).get<char>() == '?');
+    CHECK(g(Any::withBases<Derived, Base>()).get<char>() == 'B');
+  }
+}
+
+TEST_CASE("overload resolution with constness") {
+  AnyOverloadSet f{
+      [](int &) { return 1; },
+      [](const int &) { return 2; },
+  };
+  int x = 0;
+  const int y = 0;
+  CHECK(f(x).get<int>() == 1);
+  CHECK(f(y).get<int>() == 2);
+  CHECK(f(x).get<int>() == 1);
+}
+
+TEST_CASE("argument conversions") {
+  AnyFunction f = [](int, const std::string &, std::shared_ptr<int>, const Any &) {};
+  CHECK(f.argumentConversion(0, 1) == ArgumentConversion::Exact);
+  CHECK(f.argumentConversion(0, 1.5) == ArgumentConversion::Conversion);
+  CHECK(f.argumentConversion(0, short(1)) == ArgumentConversion::Promotion);
+  CHECK(f.argumentConversion(0, "a") == ArgumentConversion::None);
+  CHECK(f.argumentConversion(0, Any()) == ArgumentConversion::None);
+  CHECK(f.argumentConversion(1, "a") == ArgumentConversion::Exact);
+  CHECK(f.argumentConversion(1, 1) == ArgumentConversion::None);
+  CHECK(f.argumentConversion(2, std::make_shared<int>(1)) == ArgumentConversion::Exact);
+  CHECK(f.argumentConversion(2, 1.5) == ArgumentConversion::None);
+  CHECK(f.argumentConversion(3, 1) == ArgumentConversion::Generic);
+  CHECK(f.argumentConversion(4, 1) == ArgumentConversion::None);
+}
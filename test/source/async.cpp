@@ -0,0 +1,122 @@
+#include <doctest/doctest.h>
+#include <revisited/any_function.h>
+#include <revisited/async.h>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace revisited;
+
+TEST_CASE("ThreadPool without threads") {
+  ThreadPool pool(0);
+  CHECK(pool.size() == 1);
+  CHECK(pool.async([]() { return 1; }).get().get<int>() == 1);
+}
+
+TEST_CASE("ThreadPool") {
+  ThreadPool pool(4);
+  REQUIRE(pool.size() == 4);
+  CHECK(ThreadPool::current() == nullptr);
+
+  SUBCASE("async") {
+    auto future = pool.async([]() { return 42; });
+    CHECK(future.valid());
+    CHECK(future.get().get<int>() == 42);
+    CHECK(future.isReady());
+    CHECK(!pool.async([]() {}).get());
+  }
+
+  SUBCASE("result outlives future") {
+    const auto &result = pool.async([]() { return 42; }).get();
+    CHECK(result.get<int>() == 42);
+  }
+
+  SUBCASE("exceptions") {
+    auto future = pool.async([]() -> int { throw std::runtime_error("error"); });
+    CHECK_THROWS_AS(future.get(), std::runtime_error);
+  }
+
+  SUBCASE("many tasks") {
+    std::atomic<int> count{0};
+    std::vector<AnyFuture> futures;
+    for (int i = 0; i < 1000; ++i) {
+      futures.push_back(pool.async([&, i]() {
+        count++;
+        return i;
+      }));
+    }
+    int sum = 0;
+    for (auto &future : futures) {
+      sum += future.get().get<int>();
+    }
+    CHECK(count == 1000);
+    CHECK(sum == 999 * 1000 / 2);
+  }
+
+  SUBCASE("nested tasks") {
+    ThreadPool *current = nullptr;
+    auto future = pool.async([&]() {
+      current = ThreadPool::current();
+      std::vector<AnyFuture> inner;
+      for (int i = 0; i < 16; ++i) {
+        inner.push_back(pool.async([i]() { return i; }));
+      }
+      int sum = 0;
+      for (auto &f : inner) {
+        sum += f.get().get<int>();
+      }
+      return sum;
+    });
+    CHECK(future.get().get<int>() == 120);
+    CHECK(current == &pool);
+  }
+
+  SUBCASE("continuations") {
+    auto future = pool.async([]() { return 20; })
+                      .then([](const Any &x) { return x.get<int>() + 1; }, pool)
+                      .then([](const Any &x) { return x.get<int>() * 2; }, pool);
+    CHECK(future.get().get<int>() == 42);
+
+    auto failed = pool.async([]() -> int { throw std::runtime_error("error"); })
+                      .then([](const Any &x) { return x.get<int>() + 1; }, pool);
+    CHECK_THROWS_AS(failed.get(), std::runtime_error);
+    CHECK_THROWS_AS(AnyFuture().then([](const Any &) {}, pool), UndefinedAnyException);
+  }
+}
+
+TEST_CASE("call AnyFunction asynchronously") {
+  ThreadPool pool(2);
+  AnyFunction f = [](int a, int b) { return a + b; };
+  auto future = f.callAsync({1, 2}, pool);
+  CHECK(future.get().get<int>() == 3);
+  CHECK_THROWS_AS(f.callAsync({1}, pool).get(), AnyFunctionInvalidArgumentCountException);
+  CHECK_THROWS_AS(AnyFunction().callAsync({}, pool), UndefinedAnyFunctionException);
+}
+
+TEST_CASE("call AnyFunction asynchronously with captured references") {
+  ThreadPool pool(1);
+  std::promise<void> release;
+  auto blocker = pool.async([future = release.get_future()]() { future.wait(); });
+  AnyFunction f = [](const std::string &a, std::vector<int> b) { return a + std::to_string(b[1]); };
+
+  AnyFuture result;
+  {
+    std::string a = "a";
+    result = f.callAsync(makeAnyArguments(a, std::vector<int>{1, 2}), pool);
+    a = "b";
+  }
+  release.set_value();
+  CHECK(result.get().get<std::string>() == "a2");
+
+  struct MoveOnly {
+    MoveOnly() = default;
+    MoveOnly(MoveOnly &&) = default;
+    MoveOnly(const MoveOnly &) = delete;
+  };
+  AnyFunction g = [](const MoveOnly &) { return 1; };
+  MoveOnly value;
+  CHECK_THROWS_AS(g.callAsync(makeAnyArguments(value), pool), InvalidVisitorException);
+}
@@ -0,0 +1,75 @@
+#include <doctest/doctest.h>
+#include <revisited/function_registry.h>
+
+#include <string>
+
+using namespace revisited;
+
+TEST_CASE("function registry") {
+  FunctionRegistry registry;
+  auto add = registry.add("add", [](int a, int b) { return a + b; });
+  auto greet = registry.add("greet", [](const std::string &name) { return "hello " + name; });
+  auto sum = registry.add("sum", [](const AnyArguments &args) {
+    double result = 0;
+    for (auto &arg : args) {
+      result += arg.get<double>();
+    }
+    return result;
+  });
+
+  CHECK(registry.size() == 3);
+  CHECK_THROWS_AS(registry.add("add", []() {}), DuplicateFunctionException);
+  CHECK(registry.find("add") == add);
+  CHECK(!registry.find("sub"));
+
+  auto checkLookups = [&]() {
+    CHECK(registry.find("add") == add);
+    CHECK(registry.find(std::string("greet")) == greet);
+    CHECK(registry.get("sum") == sum);
+    CHECK(!registry.find("sub"));
+    CHECK(!registry.find(""));
+    CHECK_THROWS_WITH(registry.get("sub"), "no function registered with name");
+
+    CHECK(registry.call(add, AnyArguments{1, 2}).get<int>() == 3);
+    CHECK(registry.call("greet", AnyArguments{"world"}).get<std::string>() == "hello world");
+    CHECK(registry.call(sum, AnyArguments{1, 2, 3.5}).get<double>() == 6.5);
+  };
+
+  SUBCASE("before freezing") { checkLookups(); }
+
+  SUBCASE("frozen") {
+    registry.freeze();
+    CHECK(registry.isFrozen());
+    CHECK_THROWS_AS(registry.add("sub", []() {}), FrozenFunctionRegistryException);
+    checkLookups();
+  }
+
+  SUBCASE("signatures") {
+    auto &entry = registry[add];
+    CHECK(entry.name == "add");
+    CHECK(entry.returnType == getTypeID<int>());
+    CHECK(entry.argumentTypes == std::vector<TypeID>{getTypeID<int>(), getTypeID<int>()});
+    CHECK(!entry.isVariadic);
+    CHECK(registry[sum].isVariadic);
+  }
+}
+
+TEST_CASE("function registry perfect hash") {
+  FunctionRegistry registry;
+  std::vector<FunctionRegistry::Handle> handles;
+  for (int i = 0; i < 500; ++i) {
+    handles.push_back(registry.add("f" + std::to_string(i), [i]() { return i; }));
+  }
+  registry.freeze();
+  for (int i = 0; i < 500; ++i) {
+    auto handle = registry.find("f" + std::to_string(i));
+    REQUIRE(handle);
+    CHECK(*handle == handles[i]);
+    CHECK(registry.call(*handle, AnyArguments{}).get<int>() == i);
+    CHECK(!registry.find("g" + std::to_string(i)));
+  }
+
+  FunctionRegistry empty;
+  empty.freeze();
+  CHECK(!empty.find("f"));
+}
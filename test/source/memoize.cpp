@@ -0,0 +1,128 @@
+#include <doctest/doctest.h>
+#include <revisited/memoize.h>
+
+using namespace revisited;
+
+TEST_CASE("memoize") {
+  int calls = 0;
+  AnyFunction f = [&](int x, const std::string &y) {
+    calls++;
+    return y + std::to_string(x);
+  };
+
+  MemoizePolicy policy;
+  policy.capacity = 2;
+  policy.shards = 1;
+
+  SUBCASE("signature") {
+    auto g = memoize(f, policy);
+    CHECK(g.returnType() == getTypeID<std::string>());
+    CHECK(g.argumentCount() == 2);
+    CHECK(g.argumentType(0) == getTypeID<int>());
+    CHECK(!g.isVariadic());
+    CHECK_THROWS_AS(memoize(AnyFunction()), UndefinedAnyFunctionException);
+  }
+
+  SUBCASE("cached calls") {
+    auto g = memoize(f, policy);
+    CHECK(g(1, "a").get<std::string>() == "a1");
+    CHECK(g(1, "a").get<std::string>() == "a1");
+    CHECK(calls == 1);
+    CHECK(g(1.0, "a").get<std::string>() == "a1");
+    CHECK(calls == 2);
+    int x = 1;
+    CHECK(g(x, "a").get<std::string>() == "a1");
+    x = 2;
+    CHECK(g(x, "a").get<std::string>() == "a2");
+    CHECK(calls == 3);
+
+    auto statistics = g.statistics();
+    CHECK(statistics.hits == 2);
+    CHECK(statistics.misses == 3);
+    CHECK(statistics.evictions == 1);
+    CHECK(statistics.entries == 2);
+    CHECK(statistics.hitRate() == doctest::Approx(0.4));
+
+    g.clear();
+    CHECK(g.statistics().hits == 0);
+    g(2, "a");
+    CHECK(calls == 4);
+  }
+
+  SUBCASE("least recently used") {
+    auto g = memoize(f, policy);
+    g(1, "a");
+    g(2, "a");
+    g(1, "a");
+    g(3, "a");
+    CHECK(calls == 3);
+    g(1, "a");
+    CHECK(calls == 3);
+    g(2, "a");
+    CHECK(calls == 4);
+  }
+
+  SUBCASE("least frequently used") {
+    policy.eviction = MemoizePolicy::Eviction::LeastFrequentlyUsed;
+    auto g = memoize(f, policy);
+    g(1, "a");
+    g(1, "a");
+    g(2, "a");
+    g(3, "a");
+    CHECK(calls == 3);
+    g(1, "a");
+    CHECK(calls == 3);
+    g(2, "a");
+    CHECK(calls == 4);
+  }
+
+  SUBCASE("unhashable arguments") {
+    struct A {};
+    AnyFunction h = [&](const Any &) { return ++calls; };
+    auto g = memoize(h, policy);
+    g(A());
+    g(A());
+    CHECK(calls == 2);
+    CHECK(g.statistics().misses == 2);
+  }
+
+  SUBCASE("shards") {
+    policy.capacity = 64;
+    policy.shards = 4;
+    auto g = memoize(f, policy);
+    for (int i = 0; i < 16; ++i) {
+      CHECK(g(i, "a").get<std::string>() == "a" + std::to_string(i));
+    }
+    for (int i = 0; i < 16; ++i) {
+      g(i, "a");
+    }
+    // every shard can hold all 16 results
+    auto statistics = g.statistics();
+    CHECK(statistics.misses == 16);
+    CHECK(statistics.hits == 16);
+    CHECK(statistics.evictions == 0);
+    CHECK(statistics.entries == 16);
+  }
+
+  SUBCASE("more shards than capacity") {
+    policy.capacity = 2;
+    policy.shards = 8;
+    auto g = memoize(f, policy);
+    for (int i = 0; i < 32; ++i) {
+      g(i, "a");
+    }
+    auto statistics = g.statistics();
+    CHECK(statistics.entries == 2);
+    CHECK(statistics.evictions == 30);
+    CHECK(calls == 32);
+  }
+}
+
+TEST_CASE("memoize into result") {
+  auto f = memoize([](int x) { return x * 2; });
+  int result = 0;
+  f.callInto({2}, result);
+  CHECK(result == 4);
+  f.callInto({2}, result);
+  CHECK(f.statistics().hits == 1);
+}
@@ -0,0 +1,258 @@
+#include <doctest/doctest.h>
+#include <revisited/traversal.h>
+
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+  using namespace revisited;
+
+  struct Node : public virtual VisitableBase {
+    std::string name;
+    std::vector<Node *> childNodes;
+    const std::vector<Node *> &children() const { return childNodes; }
+  };
+
+  struct Group : public Node, public Visitable<Group> {};
+  struct Leaf : public Node, public Visitable<Leaf> {
+    int value = 1;
+  };
+
+  /**
+   * Owns the nodes of a test graph.
+   */
+  struct Graph {
+    std::vector<std::unique_ptr<Node>> nodes;
+
+    template <class T> T &add(const std::string &name, const std::vector<Node *> &children = {}) {
+      auto node = std::make_unique<T>();
+      node->name = name;
+      node->childNodes = children;
+      auto &result = *node;
+      nodes.push_back(std::move(node));
+      return result;
+    }
+  };
+
+  struct NameVisitor : public Visitor<const Group &, const Leaf &> {
+    std::string names;
+    void visit(const Group &group) override { names += group.name; }
+    void visit(const Leaf &leaf) override { names += leaf.name; }
+  };
+
+  struct HandlingVisitor : public RecursiveVisitor<const Group &, const Leaf &> {
+    std::string names;
+    bool visit(const Group &group) override {
+      names += group.name;
+      return true;
+    }
+    bool visit(const Leaf &leaf) override {
+      names += leaf.name;
+      return true;
+    }
+  };
+
+  struct SumVisitor : public Visitor<const Group &, const Leaf &> {
+    int sum = 0;
+    void visit(const Group &) override {}
+    void visit(const Leaf &leaf) override { sum += leaf.value; }
+  };
+
+  /**
+   *        a
+   *      / | \
+   *     b  e  f
+   *    / \     \
+   *   c   d     g
+   */
+  Node &makeTree(Graph &graph) {
+    auto &c = graph.add<Leaf>("c");
+    auto &d = graph.add<Leaf>("d");
+    auto &b = graph.add<Group>("b", {&c, &d});
+    auto &e = graph.add<Leaf>("e");
+    auto &g = graph.add<Leaf>("g");
+    auto &f = graph.add<Group>("f", {&g});
+    return graph.add<Group>("a", {&b, &e, &f});
+  }
+
+  struct Operation : public Visitable<Operation> {
+    std::vector<Operation> operands;
+    char name;
+    Operation(char n, std::vector<Operation> o = {}) : operands(std::move(o)), name(n) {}
+  };
+
+  struct OperationVisitor : public Visitor<const Operation &> {
+    std::string names;
+    void visit(const Operation &operation) override { names += operation.name; }
+  };
+
+}  // namespace
+
+namespace revisited {
+  template <> struct TraversalChildren<Operation> {
+    template <class F> static void forEach(const Operation &operation, F &&f) {
+      for (auto &operand : operation.operands) {
+        f(operand);
+      }
+    }
+  };
+}  // namespace revisited
+
+TEST_CASE("Traversal order") {
+  Graph graph;
+  const Node &root = makeTree(graph);
+  NameVisitor visitor;
+
+  SUBCASE("pre-order") {
+    preOrderTraversal(root, visitor);
+    CHECK(visitor.names == "abcdefg");
+  }
+
+  SUBCASE("post-order") {
+    postOrderTraversal(root, visitor);
+    CHECK(visitor.names == "cdbegfa");
+  }
+
+  SUBCASE("breadth-first") {
+    breadthFirstTraversal(root, visitor);
+    CHECK(visitor.names == "abefcdg");
+  }
+}
+
+TEST_CASE("Traversal pruning") {
+  Graph graph;
+  const Node &root = makeTree(graph);
+  NameVisitor visitor;
+  auto prune = [](const Node &node) { return node.name == "b"; };
+
+  SUBCASE("pre-order") {
+    preOrderTraversal(root, visitor, {}, prune);
+    CHECK(visitor.names == "abefg");
+  }
+
+  SUBCASE("breadth-first") {
+    breadthFirstTraversal(root, visitor, {}, prune);
+    CHECK(visitor.names == "abefg");
+  }
+
+  SUBCASE("parallel pre-order") {
+    ThreadPool pool(2);
+    auto visitors = parallelPreOrderTraversal(root, []() { return NameVisitor(); }, pool, {},
+                                              prune);
+    REQUIRE(visitors.size() == 4);
+    CHECK(visitors[1].names == "b");
+    CHECK(visitors[3].names == "fg");
+  }
+
+  SUBCASE("recursive visitor results are ignored") {
+    HandlingVisitor handling;
+    preOrderTraversal(root, handling);
+    CHECK(handling.names == "abcdefg");
+    handling.names.clear();
+    breadthFirstTraversal(root, handling);
+    CHECK(handling.names == "abefcdg");
+  }
+}
+
+TEST_CASE("Traversal of graphs") {
+  Graph graph;
+  auto &shared = graph.add<Leaf>("s");
+  auto &left = graph.add<Group>("l", {&shared});
+  auto &right = graph.add<Group>("r", {&shared});
+  Node &root = graph.add<Group>("a", {&left, &right});
+  NameVisitor visitor;
+  TraversalOptions visitOnce;
+  visitOnce.visitOnce = true;
+
+  SUBCASE("shared nodes") {
+    preOrderTraversal(root, visitor);
+    CHECK(visitor.names == "alsrs");
+  }
+
+  SUBCASE("visit once") {
+    preOrderTraversal(root, visitor, visitOnce);
+    CHECK(visitor.names == "alsr");
+  }
+
+  SUBCASE("cycles") {
+    shared.childNodes.push_back(&root);
+    SUBCASE("pre-order") {
+      preOrderTraversal(root, visitor, visitOnce);
+      CHECK(visitor.names == "alsr");
+    }
+    SUBCASE("post-order") {
+      postOrderTraversal(root, visitor, visitOnce);
+      CHECK(visitor.names == "slra");
+    }
+    SUBCASE("breadth-first") {
+      breadthFirstTraversal(root, visitor, visitOnce);
+      CHECK(visitor.names == "alrs");
+    }
+  }
+}
+
+TEST_CASE("Traversal of deep trees") {
+  Graph graph;
+  Node *node = &graph.add<Leaf>("");
+  for (size_t i = 0; i < 100000; ++i) {
+    node = &graph.add<Group>("", {node});
+  }
+  SumVisitor visitor;
+  preOrderTraversal(*node, visitor);
+  CHECK(visitor.sum == 1);
+  postOrderTraversal(*node, visitor);
+  CHECK(visitor.sum == 2);
+  breadthFirstTraversal(*node, visitor);
+  CHECK(visitor.sum == 3);
+}
+
+TEST_CASE("Traversal with custom children") {
+  const Operation product('*', {Operation('a'), Operation('b')});
+  const Operation expression('+', {product, Operation('c')});
+  OperationVisitor visitor;
+  preOrderTraversal(expression, visitor);
+  CHECK(visitor.names == "+*abc");
+}
+
+TEST_CASE("Parallel traversal") {
+  Graph graph;
+  std::vector<Node *> subtrees;
+  for (int i = 0; i < 8; ++i) {
+    std::vector<Node *> leaves;
+    for (int j = 0; j < 100; ++j) {
+      auto &leaf = graph.add<Leaf>("");
+      leaf.value = i;
+      leaves.push_back(&leaf);
+    }
+    subtrees.push_back(&graph.add<Group>("", leaves));
+  }
+  const Node &root = graph.add<Group>("", subtrees);
+
+  ThreadPool pool(2);
+  auto visitors = parallelPreOrderTraversal(root, []() { return SumVisitor(); }, pool);
+  CHECK(visitors.size() == 9);
+  auto sum = std::accumulate(visitors.begin(), visitors.end(), 0,
+                             [](int s, const SumVisitor &v) { return s + v.sum; });
+  CHECK(sum == 100 * (0 + 1 + 2 + 3 + 4 + 5 + 6 + 7));
+  CHECK(visitors[3].sum == 200);
+}
+
+TEST_CASE("Parallel traversal of graphs") {
+  Graph graph;
+  auto &shared = graph.add<Leaf>("s");
+  auto &left = graph.add<Group>("l", {&shared});
+  auto &right = graph.add<Group>("r", {&shared});
+  Node &root = graph.add<Group>("a", {&left, &right});
+  shared.childNodes.push_back(&root);
+  TraversalOptions visitOnce;
+  visitOnce.visitOnce = true;
+
+  ThreadPool pool(2);
+  auto visitors = parallelPreOrderTraversal(root, []() { return NameVisitor(); }, pool, visitOnce);
+  REQUIRE(visitors.size() == 3);
+  CHECK(visitors[0].names == "a");
+  CHECK(visitors[1].names == "ls");
+  CHECK(visitors[2].names == "rs");
+}
@@ -0,0 +1,68 @@
+#include <doctest/doctest.h>
+#include <revisited/versioned_any.h>
+
+#include <thread>
+#include <vector>
+
+using namespace revisited;
+
+TEST_CASE("versioned any") {
+  VersionedAny value(Any(1));
+  CHECK(value.load().get<int>() == 1);
+  CHECK(value.version() == 0);
+
+  auto snapshot = value.snapshot();
+  CHECK(snapshot.get().get<int>() == 1);
+  CHECK(!snapshot.refresh());
+
+  auto &cached = snapshot.value();
+  value.store(2);
+  CHECK(value.version() == 1);
+  CHECK(cached.get<int>() == 1);
+  CHECK(snapshot.refresh());
+  CHECK(snapshot.value().get<int>() == 2);
+  CHECK(snapshot.version() == 1);
+
+  CHECK(value.exchange(3).get<int>() == 2);
+  value.update([](const Any &v) { return v.get<int>() + 1; });
+  CHECK(value.load().get<int>() == 4);
+  CHECK(snapshot.get().get<int>() == 4);
+  CHECK(snapshot.version() == 3);
+}
+
+TEST_CASE("versioned any concurrent access") {
+  VersionedAny value(Any(0));
+  constexpr int updates = 1000;
+  std::vector<std::thread> readers;
+  std::vector<int> monotonic(4, true);
+
+  for (size_t i = 0; i < monotonic.size(); ++i) {
+    readers.emplace_back([&, i]() {
+      auto snapshot = value.snapshot();
+      int last = 0;
+      while (last < updates) {
+        auto current = snapshot.get().get<int>();
+        if (current < last) {
+          monotonic[i] = false;
+        }
+        last = current;
+      }
+    });
+  }
+
+  for (int i = 1; i <= updates; ++i) {
+    if (i % 2) {
+      value.store(i);
+    } else {
+      value.update([](const Any &v) { return v.get<int>() + 1; });
+    }
+  }
+
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  for (auto m : monotonic) {
+    CHECK(m);
+  }
+  CHECK(value.version() == updates);
+}
@@ -0,0 +1,126 @@
+#include <doctest/doctest.h>
+#include <revisited/visitable_collection.h>
+
+#include <string>
+
+namespace {
+  using namespace revisited;
+
+  struct A : public Visitable<A> {
+    int value;
+    explicit A(int v = 0) : value(v) {}
+  };
+
+  struct B : public DerivedVisitable<B, A> {
+    using DerivedVisitable::DerivedVisitable;
+  };
+
+  struct X : public Visitable<X> {
+    std::string name;
+    explicit X(std::string n = "") : name(std::move(n)) {}
+  };
+
+  struct AXVisitor : public Visitor<A &, const A &, X &, const X &> {
+    std::string result;
+    void visit(A &a) override { result += "A" + std::to_string(a.value); }
+    void visit(const A &a) override { result += "a" + std::to_string(a.value); }
+    void visit(X &x) override { result += "X" + x.name; }
+    void visit(const X &x) override { result += "x" + x.name; }
+  };
+
+  struct BVisitor : public Visitor<B &> {
+    int sum = 0;
+    void visit(B &b) override { sum += b.value; }
+  };
+
+}  // namespace
+
+TEST_CASE("VisitablePool") {
+  VisitablePool<A> pool;
+  CHECK(pool.empty());
+
+  auto first = pool.emplace(1);
+  auto second = pool.emplace(2);
+  std::vector<VisitablePool<A>::Handle> handles;
+  for (int i = 3; i <= 100; ++i) {
+    handles.push_back(pool.emplace(i));
+  }
+  CHECK(pool.size() == 100);
+  CHECK(pool.get(first).value == 1);
+  CHECK(pool.get(second).value == 2);
+  CHECK(pool.get(handles.back()).value == 100);
+
+  SUBCASE("erase") {
+    pool.erase(first);
+    CHECK(pool.size() == 99);
+    CHECK(!pool.contains(first));
+    CHECK(pool.tryGet(first) == nullptr);
+    CHECK_THROWS_AS(pool.get(first), InvalidVisitableHandleException);
+    CHECK_THROWS_AS(pool.erase(first), InvalidVisitableHandleException);
+    CHECK(pool.get(second).value == 2);
+    CHECK(pool.get(handles.back()).value == 100);
+
+    auto reused = pool.emplace(42);
+    CHECK(reused.slot == first.slot);
+    CHECK(reused != first);
+    CHECK(!pool.contains(first));
+    CHECK(pool.get(reused).value == 42);
+  }
+
+  SUBCASE("clear") {
+    pool.clear();
+    CHECK(pool.empty());
+    CHECK(!pool.contains(second));
+    auto handle = pool.emplace(3);
+    CHECK(pool.get(handle).value == 3);
+    CHECK(pool.size() == 1);
+  }
+
+  SUBCASE("iteration") {
+    int sum = 0;
+    for (auto &a : pool) {
+      sum += a.value;
+    }
+    CHECK(sum == 5050);
+  }
+}
+
+TEST_CASE("VisitableCollection") {
+  VisitableCollection<A, B, X> collection;
+  auto a = collection.emplace<A>(1);
+  auto b = collection.insert(B(2));
+  auto x = collection.emplace<X>("x");
+  CHECK(collection.size() == 3);
+  CHECK(collection.get(a).value == 1);
+  CHECK(collection.get(b).value == 2);
+  CHECK(collection.get(x).name == "x");
+  CHECK(collection.pool<B>().size() == 1);
+
+  SUBCASE("acceptAll") {
+    AXVisitor visitor;
+    collection.acceptAll(visitor);
+    CHECK(visitor.result == "A1A2Xx");
+
+    visitor.result.clear();
+    static_cast<const VisitableCollection<A, B, X> &>(collection).acceptAll(visitor);
+    CHECK(visitor.result == "a1a2xx");
+  }
+
+  SUBCASE("invalid visitor") {
+    BVisitor visitor;
+    CHECK_THROWS_AS(collection.acceptAll(visitor), InvalidVisitorException);
+    CHECK_NOTHROW(collection.pool<B>().acceptAll(visitor));
+    CHECK(visitor.sum == 2);
+    collection.erase(a);
+    collection.erase(x);
+    CHECK(!collection.contains(a));
+    CHECK(collection.size() == 1);
+    CHECK_NOTHROW(collection.acceptAll(visitor));
+  }
+
+  SUBCASE("clear") {
+    collection.clear();
+    CHECK(collection.empty());
+    CHECK(collection.tryGet(b) == nullptr);
+  }
+}
@@ -357,3 +357,17 @@ TEST_CASE_TEMPLATE("Numeric Visitable", TestType, char, int, float, double, unsi
     REQUIRE_THROWS_AS(std::as_const(v).accept(visitor), InvalidVisitorException);
   }
 }
+
+TEST_CASE("Referencing data") {
+  struct Base {};
+  struct Derived : public Base {};
+  struct Converting {
+    operator std::string() const { return ""; }
+  };
+  CHECK(IsReferencingData<std::reference_wrapper<int>, int>);
+  CHECK(IsReferencingData<std::reference_wrapper<const int>, const int>);
+  CHECK(IsReferencingData<Derived, Base>);
+  CHECK(!IsReferencingData<int, int>);
+  CHECK(!IsReferencingData<Converting, std::string>);
+  CHECK(!IsReferencingData<Converting, const std::string>);
+}
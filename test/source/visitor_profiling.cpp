@@ -0,0 +1,161 @@
+#include <doctest/doctest.h>
+#include <revisited/visitor.h>
+#include <revisited/visitor_profiling.h>
+
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+  using namespace revisited;
+
+  struct A : Visitable<A> {};
+  struct B : DerivedVisitable<B, A> {};
+  struct X : Visitable<X> {};
+  struct Y : Visitable<Y> {};
+
+  struct AVisitor : public Visitor<const X &, const A &> {
+    bool fail = false;
+    void visit(const X &) override {}
+    void visit(const A &) override {
+      if (fail) {
+        throw std::runtime_error("visit failed");
+      }
+    }
+  };
+
+  struct OrderedVisitor : public Visitor<const X &, const Y &, const A &> {
+    char result = 0;
+    void visit(const X &) override { result = 'X'; }
+    void visit(const Y &) override { result = 'Y'; }
+    void visit(const A &) override { result = 'A'; }
+  };
+
+  const VisitorDispatchStatistics *findPair(const VisitorStatistics &stats,
+                                            const TypeID &visitable) {
+    for (auto &p : stats.pairs) {
+      if (p.visitableType == visitable
+          && p.visitorType == getTypeID<TypeList<const X &, const A &>>()) {
+        return &p;
+      }
+    }
+    return nullptr;
+  }
+}  // namespace
+
+namespace revisited {
+  template <> struct VisitorDispatchOrder<TypeList<const X &, const Y &, const A &>> {
+    using type = TypeList<const A &, const B &>;
+  };
+}  // namespace revisited
+
+TEST_CASE("visitor profiling report") {
+  visitor_profiling::reset();
+  visitor_profiling::recordDispatch(getTypeID<A>(), getTypeID<X>(), 1, 2, true, false);
+  visitor_profiling::recordDispatch(getTypeID<A>(), getTypeID<X>(), 3, 4, true, true);
+  visitor_profiling::recordDispatch(getTypeID<B>(), getTypeID<X>(), 5, 9, false, false);
+
+  auto stats = visitor_profiling::snapshot();
+  REQUIRE(stats.pairs.size() == 2);
+  CHECK(stats.pairs[0].visitableType == getTypeID<A>());
+  CHECK(stats.pairs[0].calls == 2);
+  CHECK(stats.pairs[0].probes == 4);
+  CHECK(stats.pairs[0].comparisons == 6);
+  CHECK(stats.pairs[0].maxProbes == 3);
+  CHECK(stats.pairs[0].maxComparisons == 4);
+  CHECK(stats.pairs[0].misses == 0);
+  CHECK(stats.pairs[0].exceptions == 1);
+  CHECK(stats.pairs[1].misses == 1);
+
+  REQUIRE(stats.hottest(1).size() == 1);
+  CHECK(stats.hottest(1)[0].visitableType == getTypeID<A>());
+  REQUIRE(stats.deepest(5).size() == 2);
+  CHECK(stats.deepest(5)[0].visitableType == getTypeID<B>());
+
+  std::stringstream stream;
+  stats.write(stream);
+  CHECK(stream.str().find("\t1\t5\t9\t5\t9\t1\t0\n") != std::string::npos);
+
+  visitor_profiling::reset();
+  CHECK(visitor_profiling::snapshot().pairs.size() == 0);
+}
+
+TEST_CASE("visitor profiling hooks") {
+  visitor_profiling::reset();
+  A a;
+  B b;
+  Y y;
+  AVisitor visitor;
+
+  std::as_const(a).accept(visitor);
+  std::as_const(b).accept(visitor);
+  std::as_const(b).accept(visitor);
+  CHECK_THROWS_AS(std::as_const(y).accept(visitor), InvalidVisitorException);
+  visitor.fail = true;
+  CHECK_THROWS_AS(std::as_const(a).accept(visitor), std::runtime_error);
+
+  auto stats = visitor_profiling::snapshot();
+  if constexpr (visitor_profiling::enabled) {
+    auto aStats = findPair(stats, getTypeID<A>());
+    REQUIRE(aStats);
+    CHECK(aStats->calls == 2);
+    CHECK(aStats->probes == 2);
+    CHECK(aStats->comparisons == 4);
+    CHECK(aStats->misses == 0);
+    CHECK(aStats->exceptions == 1);
+
+    auto bStats = findPair(stats, getTypeID<B>());
+    REQUIRE(bStats);
+    CHECK(bStats->calls == 2);
+    CHECK(bStats->maxProbes > 1);
+    CHECK(bStats->misses == 0);
+
+    auto yStats = findPair(stats, getTypeID<Y>());
+    REQUIRE(yStats);
+    CHECK(yStats->calls == 1);
+    CHECK(yStats->misses == 1);
+    CHECK(yStats->exceptions == 0);
+    CHECK(yStats->comparisons == 2 * yStats->probes);
+  } else {
+    CHECK(stats.pairs.size() == 0);
+  }
+}
+
+TEST_CASE("visitor dispatch order") {
+  static_assert(std::is_same<visitor_detail::OrderedVisitorTypes<
+                                 TypeList<const A &, const B &>,
+                                 TypeList<const X &, const Y &, const A &>>::type,
+                             TypeList<const A &, const X &, const Y &>>::value);
+
+  visitor_profiling::reset();
+  A a;
+  X x;
+  OrderedVisitor visitor;
+  std::as_const(a).accept(visitor);
+  CHECK(visitor.result == 'A');
+  std::as_const(x).accept(visitor);
+  CHECK(visitor.result == 'X');
+  std::as_const(a).accept(visitor);
+
+  auto stats = visitor_profiling::snapshot();
+  if constexpr (visitor_profiling::enabled) {
+    auto visitorType = getTypeID<TypeList<const X &, const Y &, const A &>>();
+    for (auto &p : stats.pairs) {
+      if (p.visitableType == getTypeID<A>()) {
+        CHECK(p.comparisons == 2);
+      }
+    }
+    REQUIRE(stats.visitors.size() == 1);
+    CHECK(stats.visitors[0].visitorType == visitorType);
+    REQUIRE(stats.visitors[0].hits.size() == 2);
+    CHECK(stats.visitors[0].hits[0].first == getTypeID<const A &>());
+    CHECK(stats.visitors[0].hits[0].second == 2);
+    CHECK(stats.visitors[0].hits[1].first == getTypeID<const X &>());
+
+    std::stringstream stream;
+    stats.writeDispatchOrder(stream);
+    CHECK(stream.str().find("struct VisitorDispatchOrder<" + std::string(visitorType.name) + ">")
+          != std::string::npos);
+  } else {
+    CHECK(stats.visitors.size() == 0);
+  }
+}